@@ -22,6 +22,18 @@ void alloc_free_std(alloc_t *alloc, void *ptr, size_t size);
 		(_alloc)->free(_alloc, _ptr, _size);                                                                                       \
 	}
 
+void *alloc_alloc_aligned(alloc_t *alloc, size_t size, size_t align);
+int alloc_realloc_aligned(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size, size_t align);
+void alloc_free_aligned(alloc_t *alloc, void *ptr, size_t size, size_t align);
+
 #define ALLOC_STD ((alloc_t){.alloc = alloc_alloc_std, .realloc = alloc_realloc_std, .free = alloc_free_std})
 
+typedef struct grow_s {
+	unsigned int pct;
+	size_t step;
+	int exact;
+} grow_t;
+
+size_t grow_next(const grow_t *grow, size_t cur, size_t req);
+
 #endif
@@ -0,0 +1,26 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "alloc.h"
+
+typedef struct arena_block_s arena_block_t;
+
+typedef struct arena_s {
+	arena_block_t *first;
+	arena_block_t *cur;
+	size_t block_size;
+	alloc_t alloc;
+} arena_t;
+
+arena_t *arena_init(arena_t *arena, size_t block_size, alloc_t alloc);
+void arena_free(arena_t *arena);
+
+void arena_reset(arena_t *arena);
+
+void *alloc_alloc_arena(alloc_t *alloc, size_t size);
+int alloc_realloc_arena(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size);
+void alloc_free_arena(alloc_t *alloc, void *ptr, size_t size);
+
+#define ALLOC_ARENA(_arena) ((alloc_t){.alloc = alloc_alloc_arena, .realloc = alloc_realloc_arena, .free = alloc_free_arena, .priv = _arena})
+
+#endif
@@ -3,24 +3,38 @@
 
 #include "alloc.h"
 #include "dst.h"
+#include "hash.h"
 #include "type.h"
 
+typedef struct arr_idx_s arr_idx_t;
+
 typedef struct arr_s {
 	void *data;
 	uint cap;
 	uint cnt;
 	size_t size;
+	size_t align;
 	alloc_t alloc;
+	grow_t grow;
+	arr_idx_t *idx;
 } arr_t;
 
 arr_t *arr_init(arr_t *arr, uint cap, size_t size, alloc_t alloc);
+arr_t *arr_init_a(arr_t *arr, uint cap, size_t size, size_t align, alloc_t alloc);
 void arr_free(arr_t *arr);
 
 void arr_reset(arr_t *arr, uint cnt);
 
 int arr_resize(arr_t *arr, uint cap);
+int arr_reserve(arr_t *arr, uint cnt);
+int arr_shrink(arr_t *arr);
+void arr_set_grow(arr_t *arr, grow_t grow);
 
 void *arr_add(arr_t *arr, uint *id);
+void *arr_add_n(arr_t *arr, uint cnt, uint *id);
+void *arr_insert_range(arr_t *arr, uint id, uint cnt, const void *values);
+int arr_remove_range(arr_t *arr, uint id, uint cnt);
+int arr_remove_swap(arr_t *arr, uint id);
 void *arr_get(const arr_t *arr, uint id);
 void *arr_set(arr_t *arr, uint id, const void *value);
 
@@ -32,15 +46,38 @@ int arr_find(const arr_t *arr, const void *value, uint *id);
 typedef int (*arr_cmp_cb)(const void *value1, const void *value2, const void *priv);
 int arr_find_cmp(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id);
 
+// Calls that take a value keep the index up to date. Slots returned by arr_add()/arr_add_n() are searched linearly
+// until arr_index_sync() indexes them, elements changed in place through arr_get() need arr_reindex().
+int arr_index(arr_t *arr, hash_cb hash, arr_cmp_cb eq, const void *priv);
+int arr_index_sync(arr_t *arr);
+int arr_reindex(arr_t *arr);
+void arr_unindex(arr_t *arr);
+
 arr_t *arr_add_all(arr_t *arr, const arr_t *src);
 
 arr_t *arr_add_unique(arr_t *arr, const arr_t *src);
 
 arr_t *arr_merge_all(arr_t *arr, const arr_t *arr1, const arr_t *arr2);
 
+// Keeps first-seen order, use arr_union() to merge sorted inputs in linear time
 arr_t *arr_merge_unique(arr_t *arr, const arr_t *arr1, const arr_t *arr2);
 
+int arr_lower_bound(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id);
+int arr_upper_bound(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id);
+int arr_find_sorted(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id);
+int arr_add_sorted(arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id);
+
+arr_t *arr_merge_sorted(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv);
+arr_t *arr_union(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv);
+arr_t *arr_intersect(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv);
+arr_t *arr_diff(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv);
+
 arr_t *arr_sort(arr_t *arr, arr_cmp_cb cb, const void *priv);
+arr_t *arr_sort_stable(arr_t *arr, arr_cmp_cb cb, const void *priv);
+arr_t *arr_sort_par(arr_t *arr, arr_cmp_cb cb, const void *priv, uint threads);
+arr_t *arr_sort_ind(arr_t *arr, arr_cmp_cb cb, const void *priv);
+int arr_sort_idx(const arr_t *arr, arr_cmp_cb cb, const void *priv, uint *ids);
+arr_t *arr_sort_radix(arr_t *arr, size_t off, size_t len, int sign);
 
 typedef size_t (*arr_print_cb)(void *value, dst_t dst, const void *priv);
 size_t arr_print(const arr_t *arr, arr_print_cb cb, dst_t dst, const void *priv);
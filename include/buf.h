@@ -10,15 +10,21 @@ typedef struct buf_s {
 	void *data;
 	size_t size;
 	size_t used;
+	size_t align;
 	alloc_t alloc;
+	grow_t grow;
 } buf_t;
 
 void *buf_init(buf_t *buf, size_t size, alloc_t alloc);
+void *buf_init_a(buf_t *buf, size_t size, size_t align, alloc_t alloc);
 void buf_free(buf_t *buf);
 
 void buf_reset(buf_t *buf, size_t used);
 
 int buf_resize(buf_t *buf, size_t size);
+int buf_reserve(buf_t *buf, size_t size);
+int buf_shrink(buf_t *buf);
+void buf_set_grow(buf_t *buf, grow_t grow);
 
 int buf_set(buf_t *buf, size_t off, size_t size, const void *data);
 int buf_add(buf_t *buf, size_t size, const void *data, size_t *off);
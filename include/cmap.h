@@ -0,0 +1,37 @@
+#ifndef CMAP_H
+#define CMAP_H
+
+#include "alloc.h"
+#include "hash.h"
+#include "type.h"
+
+typedef struct cmap_stripe_s cmap_stripe_t;
+
+typedef struct cmap_s {
+	cmap_stripe_t *stripes;
+	uint cnt;
+	u64 seed;
+	hash_cb hash;
+	const void *priv;
+	alloc_t alloc;
+} cmap_t;
+
+// cb runs with the key's stripe spin-locked: keep it short and do not call back into the map
+typedef void *(*cmap_compute_cb)(const void *key, size_t ksize, void *priv);
+
+// the map keeps mem stats sharded (mem_shards) from cmap_init() to cmap_free() so mem_alloc() based allocators can be
+// called from several threads
+cmap_t *cmap_init(cmap_t *map, uint stripes, alloc_t alloc);
+void cmap_free(cmap_t *map);
+
+// must be called before the map is shared between threads
+int cmap_set_hash(cmap_t *map, hash_cb hash, hash_eq_cb eq, const void *priv);
+
+int cmap_set(cmap_t *map, const void *key, size_t ksize, void *value);
+int cmap_get(const cmap_t *map, const void *key, size_t ksize, void **value);
+int cmap_remove(cmap_t *map, const void *key, size_t ksize, void **value);
+int cmap_compute(cmap_t *map, const void *key, size_t ksize, cmap_compute_cb cb, void *priv, void **value);
+
+uint cmap_count(const cmap_t *map);
+
+#endif
@@ -1,12 +1,16 @@
 #ifndef dict_h
 #define dict_h
 
+#include "alloc.h"
+#include "dst.h"
+#include "hash.h"
 #include "type.h"
 
 #include <stddef.h>
 
 struct bucket {
 	struct bucket *next;
+	struct bucket *prev;
 
 	const void *key;
 	size_t ksize;
@@ -21,19 +25,36 @@ typedef struct dict_s {
 
 	struct bucket *first;
 	struct bucket *last;
+
+	u64 seed;
+	hash_cb hash;
+	hash_eq_cb eq;
+	const void *priv;
+
+	alloc_t alloc;
 } dict_t;
 
 typedef void (*dict_callback)(void *key, size_t ksize, void *value, void *priv);
 typedef void (*dict_callback_c)(void *key, size_t ksize, void *value, const void *priv);
 typedef void (*dict_callback_hc)(void *key, size_t ksize, void *value, void *priv);
 
-dict_t *dict_init(dict_t *map, int capacity);
+dict_t *dict_init(dict_t *map, int capacity, alloc_t alloc);
 void dict_free(dict_t *map);
 
-void dict_set(dict_t *map, const void *key, size_t ksize, void *value);
+int dict_set_hash(dict_t *map, hash_cb hash, hash_eq_cb eq, const void *priv);
+
+void dict_reset(dict_t *map);
+int dict_reserve(dict_t *map, int count);
+
+int dict_set(dict_t *map, const void *key, size_t ksize, void *value);
 
 int dict_get(const dict_t *map, const void *key, size_t ksize, void **out_val);
 
+int dict_remove(dict_t *map, const void *key, size_t ksize, void **out_val);
+
+int dict_probes(const dict_t *map, size_t *total, size_t *max);
+size_t dict_print_probes(const dict_t *map, dst_t dst);
+
 #define dict_foreach(_dict, _bucket) for (struct bucket *_bucket = (_dict)->first; _bucket != NULL; _bucket = _bucket->next)
 
 #endif
@@ -0,0 +1,39 @@
+#ifndef DLIST_H
+#define DLIST_H
+
+#include "arr.h"
+
+#define DLIST_END ((dlist_node_t)-1)
+
+typedef uint dlist_node_t;
+
+typedef struct dlist_s {
+	arr_t nodes;
+	dlist_node_t head;
+	dlist_node_t tail;
+	dlist_node_t free;
+	uint cnt;
+} dlist_t;
+
+dlist_t *dlist_init(dlist_t *list, uint cap, size_t size, alloc_t alloc);
+void dlist_free(dlist_t *list);
+
+void dlist_reset(dlist_t *list);
+
+void *dlist_node(dlist_t *list, dlist_node_t *node);
+int dlist_app(dlist_t *list, dlist_node_t node);
+int dlist_prep(dlist_t *list, dlist_node_t node);
+int dlist_ins(dlist_t *list, dlist_node_t prev, dlist_node_t node);
+int dlist_remove(dlist_t *list, dlist_node_t node);
+
+void *dlist_get(const dlist_t *list, dlist_node_t node);
+void *dlist_get_first(const dlist_t *list, dlist_node_t *node);
+void *dlist_get_last(const dlist_t *list, dlist_node_t *node);
+void *dlist_get_next(const dlist_t *list, dlist_node_t node, dlist_node_t *next);
+void *dlist_get_prev(const dlist_t *list, dlist_node_t node, dlist_node_t *prev);
+
+#define dlist_foreach(_list, _it, _val) for (_val = dlist_get_first(_list, &(_it)); _val; _val = dlist_get_next(_list, _it, &(_it)))
+#define dlist_foreach_rev(_list, _it, _val)                                                                                                \
+	for (_val = dlist_get_last(_list, &(_it)); _val; _val = dlist_get_prev(_list, _it, &(_it)))
+
+#endif
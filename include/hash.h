@@ -0,0 +1,14 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include "type.h"
+
+#include <stddef.h>
+
+typedef u64 (*hash_cb)(const void *key, size_t ksize, const void *priv);
+typedef int (*hash_eq_cb)(const void *key1, size_t ksize1, const void *key2, size_t ksize2, const void *priv);
+
+u64 hash_bytes(const void *data, size_t size, u64 seed);
+u64 hash_seed();
+
+#endif
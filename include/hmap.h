@@ -0,0 +1,49 @@
+#ifndef HMAP_H
+#define HMAP_H
+
+#include "alloc.h"
+#include "hash.h"
+#include "type.h"
+
+#define HMAP_GROUP  16
+#define HMAP_INLINE 16
+
+typedef struct hmap_slot_s {
+	union {
+		const void *ptr;
+		byte data[HMAP_INLINE];
+	} key;
+	size_t ksize;
+	void *value;
+} hmap_slot_t;
+
+typedef struct hmap_s {
+	u8 *ctrl;
+	hmap_slot_t *slots;
+	uint cap;
+	uint cnt;
+	uint left;
+	u64 seed;
+	hash_cb hash;
+	hash_eq_cb eq;
+	const void *priv;
+	alloc_t alloc;
+} hmap_t;
+
+hmap_t *hmap_init(hmap_t *map, uint cap, alloc_t alloc);
+void hmap_free(hmap_t *map);
+
+int hmap_set_hash(hmap_t *map, hash_cb hash, hash_eq_cb eq, const void *priv);
+
+void hmap_reset(hmap_t *map);
+
+int hmap_set(hmap_t *map, const void *key, size_t ksize, void *value);
+int hmap_get(const hmap_t *map, const void *key, size_t ksize, void **value);
+int hmap_remove(hmap_t *map, const void *key, size_t ksize, void **value);
+
+const void *hmap_key(const hmap_slot_t *slot);
+hmap_slot_t *hmap_next(const hmap_t *map, uint *i);
+
+#define hmap_foreach(_map, _i, _slot) for (; (_slot = hmap_next(_map, &_i)) != NULL; _i++)
+
+#endif
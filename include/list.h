@@ -4,7 +4,12 @@
 #include "arr.h"
 
 typedef uint list_node_t;
-typedef arr_t list_t;
+
+typedef struct list_s {
+	arr_t nodes;
+	list_node_t free;
+	uint freed;
+} list_t;
 
 list_t *list_init(list_t *list, uint cap, size_t size, alloc_t alloc);
 void list_free(list_t *list);
@@ -13,17 +18,24 @@ void list_reset(list_t *list, uint cnt);
 
 void *list_node(list_t *list, list_node_t *node);
 int list_app(list_t *list, list_node_t node, list_node_t next);
+int list_app_n(list_t *list, list_node_t node, const list_node_t *nodes, uint cnt);
+int list_set_next(list_t *list, list_node_t node, list_node_t next);
 int list_remove(list_t *list, list_node_t node);
+int list_release(list_t *list, list_node_t node);
+int list_delete(list_t *list, list_node_t node);
+int list_compact(list_t *list, list_node_t *remap);
+int list_remap(list_t *list, const list_node_t *remap);
 
 void *list_get(const list_t *list, list_node_t node);
 void *list_get_next(const list_t *list, list_node_t node, list_node_t *next);
 void *list_get_at(const list_t *list, list_node_t start, uint index, list_node_t *node);
+void *list_get_used(const list_t *list, list_node_t *node);
 
 typedef size_t (*list_print_cb)(void *value, dst_t dst, const void *priv);
 size_t list_print(const list_t *list, list_node_t node, list_print_cb cb, dst_t dst, const void *priv);
 size_t list_dbg(const list_t *list, dst_t dst);
 
 #define list_foreach(_list, _it, _val)	   for (_val = list_get(_list, _it); _val; _val = list_get_next(_list, _it, &(_it)))
-#define list_foreach_all(_list, _it, _val) for (; _it < (_list)->cnt && (_val = list_get(_list, _it)); _it++)
+#define list_foreach_all(_list, _it, _val) for (; (_val = list_get_used(_list, &(_it))) != NULL; _it++)
 
 #endif
@@ -16,6 +16,10 @@ void *mem_copy(void *dst, size_t size, const void *src, size_t len);
 void *mem_move(void *dst, size_t size, const void *src, size_t len);
 void *mem_replace(void *dst, size_t size, size_t len, const void *src, size_t old_len, size_t new_len);
 int mem_cmp(const void *l, const void *r, size_t size);
+int mem_eq(const void *l, const void *r, size_t size);
+
+void *mem_find(const void *ptr, size_t size, const void *pat, size_t len);
+void *mem_fill(void *dst, size_t size, const void *pat, size_t len);
 
 int mem_swap(void *ptr1, void *ptr2, size_t size);
 
@@ -23,4 +27,33 @@ void mem_free(void *memory, size_t size);
 
 void mem_oom(int oom);
 
+// Enabling fails while any allocation is live. Disabling drains only the calling thread's
+// caches, other threads must call mem_tcache_flush() before it.
+int mem_tcache(int enable);
+void mem_tcache_flush();
+
+// Calls nest: stats stay sharded until every mem_shards(1) is matched by a mem_shards(0)
+void mem_shards(int enable);
+void mem_merge();
+
+typedef struct mem_tag_stats_s {
+	const char *tag;
+	size_t bytes;
+	size_t live;
+	size_t peak;
+	size_t allocs;
+	size_t reallocs;
+} mem_tag_stats_t;
+
+// Tag tracking prepends a small header to every block so frees and reallocs are charged to the tag the block
+// was allocated under. Toggling fails while any allocation is live. With shards or the thread cache enabled the
+// per-tag counters are merged on read, so peak is sampled in mem_merge() like the global peak.
+int mem_tags(int enable);
+// Forgets all tags and counters, blocks allocated before the reset are no longer charged to any tag
+void mem_tags_reset();
+
+const char *mem_tag(const char *tag);
+int mem_tag_get(const char *tag, mem_tag_stats_t *stats);
+size_t mem_print_tags(dst_t dst);
+
 #endif
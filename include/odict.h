@@ -0,0 +1,56 @@
+#ifndef ODICT_H
+#define ODICT_H
+
+#include "alloc.h"
+#include "hash.h"
+#include "type.h"
+
+typedef struct odict_entry_s {
+	const void *key;
+	size_t ksize;
+	u32 hash;
+	void *value;
+} odict_entry_t;
+
+typedef struct odict_s {
+	odict_entry_t *entries;
+	uint cap;
+	uint used;
+	uint cnt;
+	uint *index;
+	uint icap;
+	uint gen;
+	u64 seed;
+	hash_cb hash;
+	hash_eq_cb eq;
+	const void *priv;
+	alloc_t alloc;
+} odict_t;
+
+typedef struct odict_snap_s {
+	uint used;
+	uint gen;
+} odict_snap_t;
+
+odict_t *odict_init(odict_t *map, uint cap, alloc_t alloc);
+void odict_free(odict_t *map);
+
+int odict_set_hash(odict_t *map, hash_cb hash, hash_eq_cb eq, const void *priv);
+
+void odict_reset(odict_t *map);
+int odict_compact(odict_t *map);
+
+int odict_set(odict_t *map, const void *key, size_t ksize, void *value);
+int odict_get(const odict_t *map, const void *key, size_t ksize, void **value);
+int odict_remove(odict_t *map, const void *key, size_t ksize, void **value);
+
+odict_entry_t *odict_next(const odict_t *map, uint *i);
+
+odict_snap_t odict_snap(const odict_t *map);
+int odict_snap_valid(const odict_t *map, const odict_snap_t *snap);
+odict_entry_t *odict_snap_next(const odict_t *map, const odict_snap_t *snap, uint *i);
+
+#define odict_foreach(_map, _i, _entry)		   for (; (_entry = odict_next(_map, &_i)) != NULL; _i++)
+#define odict_snap_foreach(_map, _snap, _i, _entry) for (; (_entry = odict_snap_next(_map, _snap, &_i)) != NULL; _i++)
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include "alloc.h"
+#include "type.h"
+
+#define SLAB_MIN_SIZE 16
+#define SLAB_CLASSES  8
+
+typedef struct slab_page_s slab_page_t;
+
+typedef struct slab_s {
+	void *free[SLAB_CLASSES];
+	slab_page_t *pages;
+	size_t page_size;
+	alloc_t alloc;
+} slab_t;
+
+slab_t *slab_init(slab_t *slab, size_t page_size, alloc_t alloc);
+void slab_free(slab_t *slab);
+
+int slab_reserve(slab_t *slab, size_t size, uint cnt);
+
+void *alloc_alloc_slab(alloc_t *alloc, size_t size);
+int alloc_realloc_slab(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size);
+void alloc_free_slab(alloc_t *alloc, void *ptr, size_t size);
+
+#define ALLOC_SLAB(_slab) ((alloc_t){.alloc = alloc_alloc_slab, .realloc = alloc_realloc_slab, .free = alloc_free_slab, .priv = _slab})
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef SOA_H
+#define SOA_H
+
+#include "alloc.h"
+#include "type.h"
+
+typedef struct soa_col_s {
+	void *data;
+	size_t size;
+	uint cap;
+} soa_col_t;
+
+typedef struct soa_s {
+	soa_col_t *cols;
+	uint ncols;
+	uint cap;
+	uint cnt;
+	alloc_t alloc;
+	grow_t grow;
+} soa_t;
+
+soa_t *soa_init(soa_t *soa, uint cap, const size_t *sizes, uint ncols, alloc_t alloc);
+void soa_free(soa_t *soa);
+
+void soa_reset(soa_t *soa, uint cnt);
+
+int soa_resize(soa_t *soa, uint cap);
+void soa_set_grow(soa_t *soa, grow_t grow);
+
+int soa_add(soa_t *soa, uint *id);
+int soa_addv(soa_t *soa, const void *const *values, uint *id);
+
+void *soa_col(const soa_t *soa, uint col);
+void *soa_get(const soa_t *soa, uint col, uint id);
+int soa_row(const soa_t *soa, uint id, void **values);
+
+#define soa_col_as(_soa, _type, _col)	    ((_type *)soa_col(_soa, _col))
+#define soa_get_as(_soa, _type, _col, _id) ((_type *)soa_get(_soa, _col, _id))
+
+#define soa_foreach(_soa, _i, _values) for (; _i < (_soa)->cnt && soa_row(_soa, _i, _values) == 0; _i++)
+#define soa_foreach_col(_soa, _col, _i, _val)                                                                                              \
+	for (; _i < (_soa)->cnt && (_val = (void *)((byte *)(_soa)->cols[_col].data + _i * (_soa)->cols[_col].size)); _i++)
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SYNC_H
+#define SYNC_H
+
+#include "platform.h"
+#include "type.h"
+
+#include <stddef.h>
+
+#if defined(C_WIN)
+	#define SYNC_TLS __declspec(thread)
+#else
+	#include <pthread.h>
+	#define SYNC_TLS _Thread_local
+#endif
+
+typedef struct lock_s {
+	volatile long locked;
+} lock_t;
+
+void lock_acquire(lock_t *lock);
+void lock_release(lock_t *lock);
+
+size_t atom_add(volatile size_t *val, size_t add);
+size_t atom_xchg(volatile size_t *val, size_t set);
+size_t atom_load(const volatile size_t *val);
+int atom_cas(volatile size_t *val, size_t expected, size_t desired);
+int atom_cas_ptr(void *volatile *ptr, void *expected, void *desired);
+
+u64 atom_load64(const volatile u64 *val);
+int atom_cas64(volatile u64 *val, u64 expected, u64 desired);
+
+typedef void (*thread_cb)(void *priv);
+
+typedef struct thread_s {
+#if defined(C_WIN)
+	void *handle;
+#else
+	pthread_t handle;
+#endif
+	thread_cb cb;
+	void *priv;
+} thread_t;
+
+int thread_create(thread_t *thread, thread_cb cb, void *priv);
+int thread_join(thread_t *thread);
+unsigned int thread_cpus();
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "alloc.h"
+#include "dst.h"
+#include "type.h"
+
+#define TRACE_DEPTH 8
+
+typedef struct trace_entry_s {
+	void *ptr;
+	size_t size;
+	uint site;
+} trace_entry_t;
+
+typedef struct trace_site_s {
+	const char *tag;
+	size_t calls;
+	size_t bytes;
+	size_t live;
+	size_t cnt;
+} trace_site_t;
+
+typedef struct trace_s {
+	alloc_t alloc;
+	trace_entry_t *entries;
+	void **frames;
+	uint cap;
+	uint cnt;
+	trace_site_t *sites;
+	uint sites_cap;
+	uint sites_cnt;
+	uint site;
+	int backtrace;
+} trace_t;
+
+enum {
+	TRACE_BY_LIVE,
+	TRACE_BY_BYTES,
+	TRACE_BY_CALLS,
+};
+
+trace_t *trace_init(trace_t *trace, alloc_t alloc, int backtrace);
+void trace_free(trace_t *trace);
+
+const char *trace_tag(trace_t *trace, const char *tag);
+
+size_t trace_print(const trace_t *trace, int by, uint n, dst_t dst);
+size_t trace_print_live(const trace_t *trace, uint n, dst_t dst);
+
+void *alloc_alloc_trace(alloc_t *alloc, size_t size);
+int alloc_realloc_trace(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size);
+void alloc_free_trace(alloc_t *alloc, void *ptr, size_t size);
+
+#define ALLOC_TRACE(_trace) ((alloc_t){.alloc = alloc_alloc_trace, .realloc = alloc_realloc_trace, .free = alloc_free_trace, .priv = _trace})
+
+#endif
@@ -17,10 +17,20 @@ void *tree_node(tree_t *tree, tree_node_t *node);
 int tree_add(tree_t *tree, tree_node_t node, tree_node_t child);
 int tree_app(tree_t *tree, tree_node_t node, tree_node_t next);
 int tree_remove(tree_t *tree, tree_node_t node);
+int tree_move(tree_t *tree, tree_node_t node, tree_node_t parent);
+int tree_delete(tree_t *tree, tree_node_t node);
+int tree_compact(tree_t *tree, tree_node_t *remap);
+int tree_freeze(tree_t *tree, tree_node_t *remap);
 
 void *tree_get(const tree_t *tree, tree_node_t node);
 void *tree_get_child(const tree_t *tree, tree_node_t node, tree_node_t *child);
 void *tree_get_next(const tree_t *tree, tree_node_t node, tree_node_t *next);
+void *tree_get_parent(const tree_t *tree, tree_node_t node, tree_node_t *parent);
+
+int tree_depth(const tree_t *tree, tree_node_t node);
+uint tree_path(const tree_t *tree, tree_node_t node, tree_node_t *path, uint cap);
+uint tree_size(const tree_t *tree, tree_node_t node);
+int tree_is_ancestor(const tree_t *tree, tree_node_t node, tree_node_t of);
 
 typedef int (*tree_iterate_cb)(const tree_t *tree, tree_node_t node, void *value, int ret, int depth, int last, void *priv);
 int tree_iterate_pre(const tree_t *tree, tree_node_t node, tree_iterate_cb cb, int ret, void *priv);
@@ -42,10 +52,10 @@ void *tree_it_next(tree_it *it);
 
 #define tree_foreach(_tree, _start, _node, _depth)                                                                                         \
 	for (tree_it _it = tree_it_begin(_tree, _start);                                                                                   \
-	     ((_depth = _it.top - 1) >= 0) && ((_node = _it.stack[_it.top - 1]) < (_tree)->cnt);                                           \
+	     ((_depth = _it.top - 1) >= 0) && ((_node = _it.stack[_it.top - 1]) < (_tree)->nodes.cnt);                                           \
 	     tree_it_next(&_it))
 
-#define tree_foreach_all(_tree, _node) for (; _node < (_tree)->cnt; _node++)
+#define tree_foreach_all(_tree, _node) for (; list_get_used(_tree, &(_node)) != NULL; _node++)
 
 #define tree_foreach_child(_tree, _parent, _node, _data)                                                                                   \
 	for ((_data) = tree_get_child(_tree, _parent, &(_node)); (_data); (_data) = tree_get_next(_tree, _node, &(_node)))
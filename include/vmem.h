@@ -0,0 +1,32 @@
+#ifndef VMEM_H
+#define VMEM_H
+
+#include "alloc.h"
+
+enum {
+	VMEM_THP     = 1 << 0,
+	VMEM_HUGETLB = 1 << 1,
+};
+
+typedef struct vmem_s {
+	void *base;
+	size_t reserved;
+	size_t committed;
+	size_t used;
+	size_t last;
+	size_t page;
+	int flags;
+} vmem_t;
+
+vmem_t *vmem_init(vmem_t *vmem, size_t reserve, int flags);
+void vmem_free(vmem_t *vmem);
+
+void vmem_reset(vmem_t *vmem);
+
+void *alloc_alloc_vmem(alloc_t *alloc, size_t size);
+int alloc_realloc_vmem(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size);
+void alloc_free_vmem(alloc_t *alloc, void *ptr, size_t size);
+
+#define ALLOC_VMEM(_vmem) ((alloc_t){.alloc = alloc_alloc_vmem, .realloc = alloc_realloc_vmem, .free = alloc_free_vmem, .priv = _vmem})
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "log.h"
 #include "mem.h"
+#include "type.h"
 
 void *alloc_alloc_std(alloc_t *alloc, size_t size)
 {
@@ -29,3 +30,126 @@ void alloc_free_std(alloc_t *alloc, void *ptr, size_t size)
 	(void)alloc;
 	mem_free(ptr, size);
 }
+
+static size_t aligned_extra(size_t *align)
+{
+	if (*align < sizeof(size_t)) {
+		*align = sizeof(size_t);
+	}
+
+	return *align - 1 + sizeof(size_t);
+}
+
+static void *aligned_ptr(void *raw, size_t align)
+{
+	return (void *)(((size_t)raw + sizeof(size_t) + align - 1) & ~(align - 1));
+}
+
+static void aligned_set(void *ptr, void *raw)
+{
+	size_t off = (size_t)((byte *)ptr - (byte *)raw);
+	mem_copy((byte *)ptr - sizeof(size_t), sizeof(size_t), &off, sizeof(size_t));
+}
+
+static void *aligned_raw(void *ptr, size_t *off)
+{
+	mem_copy(off, sizeof(size_t), (byte *)ptr - sizeof(size_t), sizeof(size_t));
+	return (byte *)ptr - *off;
+}
+
+void *alloc_alloc_aligned(alloc_t *alloc, size_t size, size_t align)
+{
+	if (align == 0) {
+		return alloc_alloc(alloc, size);
+	}
+
+	if (align & (align - 1)) {
+		log_error("cutils", "alloc", NULL, "alignment not a power of two: %zu", align);
+		return NULL;
+	}
+
+	size_t extra = aligned_extra(&align);
+
+	void *raw = alloc_alloc(alloc, size + extra);
+	if (raw == NULL) {
+		return NULL;
+	}
+
+	void *ptr = aligned_ptr(raw, align);
+	aligned_set(ptr, raw);
+
+	return ptr;
+}
+
+int alloc_realloc_aligned(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size, size_t align)
+{
+	if (align == 0) {
+		return alloc_realloc(alloc, ptr, old_size, new_size);
+	}
+
+	if (*ptr == NULL) {
+		*ptr = alloc_alloc_aligned(alloc, new_size, align);
+		if (*ptr == NULL) {
+			return 1;
+		}
+
+		*old_size = new_size;
+		return 0;
+	}
+
+	size_t extra = aligned_extra(&align);
+
+	size_t off;
+	void *raw	= aligned_raw(*ptr, &off);
+	size_t raw_size = *old_size + extra;
+	if (alloc_realloc(alloc, &raw, &raw_size, new_size + extra)) {
+		return 1;
+	}
+
+	void *data = aligned_ptr(raw, align);
+	if ((size_t)((byte *)data - (byte *)raw) != off) {
+		mem_move(data, new_size, (byte *)raw + off, *old_size < new_size ? *old_size : new_size);
+	}
+	aligned_set(data, raw);
+
+	*ptr	  = data;
+	*old_size = new_size;
+
+	return 0;
+}
+
+void alloc_free_aligned(alloc_t *alloc, void *ptr, size_t size, size_t align)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	if (align == 0) {
+		alloc_free(alloc, ptr, size);
+		return;
+	}
+
+	size_t extra = aligned_extra(&align);
+
+	size_t off;
+	void *raw = aligned_raw(ptr, &off);
+	alloc_free(alloc, raw, size + extra);
+}
+
+#define GROW_PCT 200
+
+size_t grow_next(const grow_t *grow, size_t cur, size_t req)
+{
+	if (req <= cur) {
+		return cur;
+	}
+
+	size_t pct  = grow && grow->pct ? grow->pct : GROW_PCT;
+	size_t next = cur > (size_t)-1 / pct ? (size_t)-1 : cur * pct / 100;
+
+	if (grow && grow->step && next - cur > grow->step) {
+		next = cur + grow->step;
+	}
+
+	return next < req ? req : next;
+}
@@ -0,0 +1,159 @@
+#include "arena.h"
+
+#include "log.h"
+#include "mem.h"
+#include "type.h"
+
+#define ARENA_ALIGN (2 * sizeof(void *))
+
+#define ALIGN(_size) (((_size) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+struct arena_block_s {
+	arena_block_t *next;
+	size_t size;
+	size_t used;
+};
+
+#define BLOCK_HEADER ALIGN(sizeof(arena_block_t))
+#define BLOCK_DATA(_block) ((byte *)(_block) + BLOCK_HEADER)
+
+arena_t *arena_init(arena_t *arena, size_t block_size, alloc_t alloc)
+{
+	if (arena == NULL) {
+		return NULL;
+	}
+
+	arena->first	  = NULL;
+	arena->cur	  = NULL;
+	arena->block_size = ALIGN(block_size);
+	arena->alloc	  = alloc;
+
+	return arena;
+}
+
+void arena_free(arena_t *arena)
+{
+	if (arena == NULL) {
+		return;
+	}
+
+	arena_block_t *block = arena->first;
+	while (block) {
+		arena_block_t *next = block->next;
+		alloc_free(&arena->alloc, block, BLOCK_HEADER + block->size);
+		block = next;
+	}
+
+	arena->first = NULL;
+	arena->cur   = NULL;
+}
+
+void arena_reset(arena_t *arena)
+{
+	if (arena == NULL) {
+		return;
+	}
+
+	arena->cur = arena->first;
+	if (arena->cur) {
+		arena->cur->used = 0;
+	}
+}
+
+static arena_block_t *arena_block(arena_t *arena, size_t size)
+{
+	arena_block_t *next = arena->cur ? arena->cur->next : arena->first;
+	if (next && next->size >= size) {
+		next->used = 0;
+		return next;
+	}
+
+	size_t block_size = size > arena->block_size ? size : arena->block_size;
+
+	arena_block_t *block = alloc_alloc(&arena->alloc, BLOCK_HEADER + block_size);
+	if (block == NULL) {
+		log_error("cutils", "arena", NULL, "failed to allocate block");
+		return NULL;
+	}
+
+	block->size = block_size;
+	block->used = 0;
+
+	if (arena->cur) {
+		block->next	 = arena->cur->next;
+		arena->cur->next = block;
+	} else {
+		block->next  = arena->first;
+		arena->first = block;
+	}
+
+	return block;
+}
+
+void *alloc_alloc_arena(alloc_t *alloc, size_t size)
+{
+	arena_t *arena = alloc->priv;
+	if (arena == NULL) {
+		return NULL;
+	}
+
+	size = ALIGN(size);
+
+	arena_block_t *block = arena->cur;
+	if (block == NULL || block->size - block->used < size) {
+		block = arena_block(arena, size);
+		if (block == NULL) {
+			return NULL;
+		}
+		arena->cur = block;
+	}
+
+	void *ptr = BLOCK_DATA(block) + block->used;
+	block->used += size;
+
+	return ptr;
+}
+
+int alloc_realloc_arena(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size)
+{
+	arena_t *arena = alloc->priv;
+	if (arena == NULL) {
+		return 1;
+	}
+
+	size_t old_aligned   = ALIGN(*old_size);
+	size_t new_aligned   = ALIGN(new_size);
+	arena_block_t *block = arena->cur;
+
+	if (block && (byte *)*ptr + old_aligned == BLOCK_DATA(block) + block->used &&
+	    (new_aligned <= old_aligned || new_aligned - old_aligned <= block->size - block->used)) {
+		block->used = block->used - old_aligned + new_aligned;
+		*old_size   = new_size;
+		return 0;
+	}
+
+	if (new_size <= old_aligned) {
+		*old_size = new_size;
+		return 0;
+	}
+
+	void *data = alloc_alloc_arena(alloc, new_size);
+	if (data == NULL) {
+		log_error("cutils", "arena", NULL, "failed to reallocate memory");
+		return 1;
+	}
+
+	mem_copy(data, new_size, *ptr, *old_size);
+
+	*ptr	  = data;
+	*old_size = new_size;
+
+	return 0;
+}
+
+void alloc_free_arena(alloc_t *alloc, void *ptr, size_t size)
+{
+	(void)alloc;
+	(void)ptr;
+	(void)size;
+}
@@ -1,15 +1,27 @@
 #include "arr.h"
 
+#include "hash.h"
 #include "log.h"
 #include "mem.h"
+#include "sync.h"
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+#define ELEM(_base, _i, _size) ((byte *)(_base) + (size_t)(_i) * (_size))
 
 arr_t *arr_init(arr_t *arr, uint cap, size_t size, alloc_t alloc)
+{
+	return arr_init_a(arr, cap, size, 0, alloc);
+}
+
+arr_t *arr_init_a(arr_t *arr, uint cap, size_t size, size_t align, alloc_t alloc)
 {
 	if (arr == NULL) {
 		return NULL;
 	}
 
-	void *data = alloc_alloc(&alloc, cap * size);
+	void *data = alloc_alloc_aligned(&alloc, cap * size, align);
 	if (data == NULL) {
 		log_error("cutils", "arr", NULL, "failed to allocate memory");
 		return NULL;
@@ -19,7 +31,10 @@ arr_t *arr_init(arr_t *arr, uint cap, size_t size, alloc_t alloc)
 	arr->cap   = cap;
 	arr->cnt   = 0;
 	arr->size  = size;
+	arr->align = align;
 	arr->alloc = alloc;
+	arr->grow  = (grow_t){0};
+	arr->idx   = NULL;
 
 	return arr;
 }
@@ -30,249 +45,1402 @@ void arr_free(arr_t *arr)
 		return;
 	}
 
-	alloc_free(&arr->alloc, arr->data, arr->cap * arr->size);
+	arr_unindex(arr);
+
+	alloc_free_aligned(&arr->alloc, arr->data, arr->cap * arr->size, arr->align);
 	arr->data = NULL;
 	arr->cap  = 0;
 	arr->cnt  = 0;
 	arr->size = 0;
 }
 
-void arr_reset(arr_t *arr, uint cnt)
+#define IDX_EMPTY    ((uint)-1)
+#define IDX_MIN_SIZE 16
+
+typedef struct idx_slot_s {
+	uint id;
+	uint hash;
+} idx_slot_t;
+
+struct arr_idx_s {
+	hash_cb hash;
+	arr_cmp_cb eq;
+	const void *priv;
+	idx_slot_t *slots;
+	uint cap;
+	uint cnt;
+	uint indexed;
+};
+
+static uint idx_hash(const arr_t *arr, const void *value)
 {
-	if (arr == NULL) {
-		return;
+	const arr_idx_t *idx = arr->idx;
+
+	if (idx->hash) {
+		u64 hash = idx->hash(value, arr->size, idx->priv);
+		return (uint)(hash ^ hash >> 32);
 	}
 
-	if (cnt > arr->cnt) {
-		cnt = arr->cnt;
+	u64 hash = hash_bytes(value, arr->size, hash_seed());
+	return (uint)(hash ^ hash >> 32);
+}
+
+static int idx_eq(const arr_t *arr, const void *value1, const void *value2)
+{
+	const arr_idx_t *idx = arr->idx;
+	return idx->eq ? idx->eq(value1, value2, idx->priv) != 0 : mem_cmp(value1, value2, arr->size) == 0;
+}
+
+static uint idx_clear(arr_t *arr)
+{
+	arr_idx_t *idx = arr->idx;
+	if (idx == NULL) {
+		return 0;
 	}
 
-	arr->cnt = cnt;
+	for (uint i = 0; i < idx->cap; i++) {
+		idx->slots[i].id = IDX_EMPTY;
+	}
+
+	uint indexed = idx->indexed;
+	idx->cnt     = 0;
+	idx->indexed = 0;
+
+	return indexed;
 }
 
-int arr_resize(arr_t *arr, uint cap)
+static int idx_grow(arr_t *arr, uint cap)
 {
-	if (arr == NULL) {
+	arr_idx_t *idx = arr->idx;
+
+	idx_slot_t *slots = alloc_alloc(&arr->alloc, cap * sizeof(idx_slot_t));
+	if (slots == NULL) {
+		log_error("cutils", "arr", NULL, "failed to allocate index");
 		return 1;
 	}
 
-	if (cap <= arr->cap) {
-		return 0;
+	for (uint i = 0; i < cap; i++) {
+		slots[i].id = IDX_EMPTY;
 	}
 
-	size_t old_size = arr->cap * arr->size;
-	if (alloc_realloc(&arr->alloc, &arr->data, &old_size, cap * arr->size)) {
-		log_error("cutils", "arr", NULL, "failed to resize array");
-		return 1;
+	for (uint i = 0; i < idx->cap; i++) {
+		if (idx->slots[i].id == IDX_EMPTY) {
+			continue;
+		}
+
+		uint pos = idx->slots[i].hash & (cap - 1);
+		while (slots[pos].id != IDX_EMPTY) {
+			pos = (pos + 1) & (cap - 1);
+		}
+		slots[pos] = idx->slots[i];
 	}
 
-	arr->cap = cap;
+	if (idx->slots) {
+		alloc_free(&arr->alloc, idx->slots, idx->cap * sizeof(idx_slot_t));
+	}
+
+	idx->slots = slots;
+	idx->cap   = cap;
 
 	return 0;
 }
 
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
+static int idx_insert(arr_t *arr, uint id)
+{
+	arr_idx_t *idx = arr->idx;
 
-void *arr_add(arr_t *arr, uint *id)
+	if ((idx->cnt + 1) * 2 > idx->cap && idx_grow(arr, MAX(IDX_MIN_SIZE, idx->cap * 2))) {
+		return 1;
+	}
+
+	uint hash = idx_hash(arr, (byte *)arr->data + id * arr->size);
+	uint pos  = hash & (idx->cap - 1);
+	while (idx->slots[pos].id != IDX_EMPTY) {
+		pos = (pos + 1) & (idx->cap - 1);
+	}
+
+	idx->slots[pos] = (idx_slot_t){.id = id, .hash = hash};
+	idx->cnt++;
+
+	return 0;
+}
+
+static void idx_remove(arr_t *arr, uint id)
 {
-	if (arr == NULL) {
-		return NULL;
+	arr_idx_t *idx = arr->idx;
+	if (idx->cap == 0) {
+		return;
 	}
 
-	if (arr->cnt >= arr->cap && arr_resize(arr, MAX(1, arr->cap * 2))) {
-		log_error("cutils", "arr", NULL, "failed to add element");
-		return NULL;
+	uint mask = idx->cap - 1;
+	uint pos  = idx_hash(arr, (byte *)arr->data + id * arr->size) & mask;
+	while (idx->slots[pos].id != id) {
+		if (idx->slots[pos].id == IDX_EMPTY) {
+			return;
+		}
+		pos = (pos + 1) & mask;
 	}
 
-	if (id) {
-		*id = arr->cnt;
+	for (uint next = (pos + 1) & mask; idx->slots[next].id != IDX_EMPTY; next = (next + 1) & mask) {
+		uint home = idx->slots[next].hash & mask;
+		if (((next - home) & mask) >= ((next - pos) & mask)) {
+			idx->slots[pos] = idx->slots[next];
+			pos		= next;
+		}
 	}
 
-	return (byte *)arr->data + (arr->cnt++) * arr->size;
+	idx->slots[pos].id = IDX_EMPTY;
+	idx->cnt--;
 }
 
-void *arr_get(const arr_t *arr, uint id)
+static int idx_sync(arr_t *arr, uint cnt)
 {
-	if (arr == NULL) {
-		return NULL;
+	arr_idx_t *idx = arr->idx;
+
+	while (idx->indexed < cnt) {
+		if (idx_insert(arr, idx->indexed)) {
+			return 1;
+		}
+		idx->indexed++;
 	}
 
-	if (id >= arr->cnt) {
-		log_error("cutils", "arr", NULL, "invalid id: %d", id);
-		return NULL;
+	return 0;
+}
+
+// Reindexes the first cnt elements after they were moved, on failure the index is left empty
+static void idx_rebuild(arr_t *arr, uint cnt)
+{
+	if (arr->idx == NULL) {
+		return;
 	}
 
-	return (byte *)arr->data + id * arr->size;
+	idx_clear(arr);
+	if (idx_sync(arr, cnt)) {
+		idx_clear(arr);
+	}
 }
 
-void *arr_set(arr_t *arr, uint id, const void *value)
+// Indexes an element appended with a known value when everything before it is indexed
+static void idx_append(arr_t *arr, uint id)
 {
-	if (arr == NULL || value == NULL) {
-		return NULL;
+	arr_idx_t *idx = arr->idx;
+	if (idx == NULL || idx->indexed != id) {
+		return;
 	}
 
-	void *dst = arr_get(arr, id);
-	if (dst == NULL) {
-		return NULL;
+	if (idx_sync(arr, id + 1)) {
+		idx_clear(arr);
 	}
+}
 
-	if (value) {
-		mem_copy(dst, arr->size, value, arr->size);
+static arr_t *idx_sorted(arr_t *arr, uint indexed)
+{
+	if (indexed == arr->cnt) {
+		idx_rebuild(arr, indexed);
 	}
 
-	return dst;
+	return arr;
 }
 
-int arr_addv(arr_t *arr, const void *value, uint *id)
+static int idx_find(const arr_t *arr, const void *value, uint *id)
 {
-	if (arr == NULL || value == NULL) {
+	const arr_idx_t *idx = arr->idx;
+	if (idx->cap == 0) {
 		return 1;
 	}
 
-	void *data = arr_add(arr, id);
-	if (data == NULL) {
+	uint mask  = idx->cap - 1;
+	uint hash  = idx_hash(arr, value);
+	uint found = IDX_EMPTY;
+	for (uint pos = hash & mask; idx->slots[pos].id != IDX_EMPTY; pos = (pos + 1) & mask) {
+		const idx_slot_t *slot = &idx->slots[pos];
+		if (slot->hash == hash && slot->id < found && idx_eq(arr, (byte *)arr->data + slot->id * arr->size, value)) {
+			found = slot->id;
+		}
+	}
+
+	if (found == IDX_EMPTY) {
 		return 1;
 	}
 
-	mem_copy(data, arr->size, value, arr->size);
+	if (id) {
+		*id = found;
+	}
 
 	return 0;
 }
 
-int arr_addu(arr_t *arr, const void *value, uint *id)
+int arr_index(arr_t *arr, hash_cb hash, arr_cmp_cb eq, const void *priv)
 {
-	if (arr == NULL || value == NULL) {
+	if (arr == NULL) {
 		return 1;
 	}
 
-	if (arr_find(arr, value, id) == 0) {
-		return 0;
+	arr_unindex(arr);
+
+	arr_idx_t *idx = alloc_alloc(&arr->alloc, sizeof(arr_idx_t));
+	if (idx == NULL) {
+		log_error("cutils", "arr", NULL, "failed to allocate index");
+		return 1;
 	}
 
-	return arr_addv(arr, value, id);
+	*idx	 = (arr_idx_t){.hash = hash, .eq = eq, .priv = priv};
+	arr->idx = idx;
+
+	uint cap = IDX_MIN_SIZE;
+	while (cap < arr->cnt * 2) {
+		cap *= 2;
+	}
+
+	if (idx_grow(arr, cap) || idx_sync(arr, arr->cnt)) {
+		arr_unindex(arr);
+		return 1;
+	}
+
+	return 0;
 }
 
-int arr_find(const arr_t *arr, const void *value, uint *id)
+void arr_unindex(arr_t *arr)
 {
-	if (arr == NULL || value == NULL) {
-		return 1;
+	if (arr == NULL || arr->idx == NULL) {
+		return;
 	}
 
-	for (uint i = 0; i < arr->cnt; i++) {
-		if (mem_cmp(arr_get(arr, i), value, arr->size) == 0) {
-			if (id) {
-				*id = i;
-			}
-			return 0;
-		}
+	if (arr->idx->slots) {
+		alloc_free(&arr->alloc, arr->idx->slots, arr->idx->cap * sizeof(idx_slot_t));
 	}
 
-	return 1;
+	alloc_free(&arr->alloc, arr->idx, sizeof(arr_idx_t));
+	arr->idx = NULL;
 }
 
-int arr_find_cmp(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id)
+int arr_reindex(arr_t *arr)
 {
-	if (arr == NULL || value == NULL || cb == NULL) {
+	if (arr == NULL || arr->idx == NULL) {
 		return 1;
 	}
 
-	for (uint i = 0; i < arr->cnt; i++) {
-		if (cb(arr_get(arr, i), value, priv)) {
-			if (id) {
-				*id = i;
-			}
-			return 0;
-		}
+	idx_clear(arr);
+
+	return idx_sync(arr, arr->cnt);
+}
+
+int arr_index_sync(arr_t *arr)
+{
+	if (arr == NULL || arr->idx == NULL) {
+		return 1;
 	}
 
-	return 1;
+	return idx_sync(arr, arr->cnt);
 }
 
-arr_t *arr_add_all(arr_t *arr, const arr_t *src)
+void arr_reset(arr_t *arr, uint cnt)
 {
-	if (arr == NULL || src == NULL || arr->cap - arr->cnt < src->cnt || arr->size != src->size) {
-		return NULL;
+	if (arr == NULL) {
+		return;
 	}
 
-	mem_copy((byte *)arr->data + arr->cnt * arr->size, arr->cap * arr->size - arr->cnt * arr->size, src->data, src->cnt * src->size);
+	if (cnt > arr->cnt) {
+		cnt = arr->cnt;
+	}
 
-	arr->cnt += src->cnt;
+	if (arr->idx && cnt == 0) {
+		idx_clear(arr);
+	}
 
-	return arr;
+	while (arr->idx && arr->idx->indexed > cnt) {
+		idx_remove(arr, --arr->idx->indexed);
+	}
+
+	arr->cnt = cnt;
 }
 
-arr_t *arr_add_unique(arr_t *arr, const arr_t *src)
+int arr_resize(arr_t *arr, uint cap)
 {
-	if (arr == NULL || src == NULL || arr->size != src->size) {
-		return NULL;
+	if (arr == NULL) {
+		return 1;
 	}
 
-	for (uint i = 0; i < src->cnt; i++) {
-		if (arr_addu(arr, arr_get(src, i), NULL)) {
-			return NULL;
-		}
+	if (cap <= arr->cap) {
+		return 0;
 	}
 
-	return arr;
+	size_t old_size = arr->cap * arr->size;
+	if (alloc_realloc_aligned(&arr->alloc, &arr->data, &old_size, cap * arr->size, arr->align)) {
+		log_error("cutils", "arr", NULL, "failed to resize array");
+		return 1;
+	}
+
+	arr->cap = cap;
+
+	return 0;
 }
 
-arr_t *arr_merge_all(arr_t *arr, const arr_t *arr1, const arr_t *arr2)
+int arr_reserve(arr_t *arr, uint cnt)
 {
-	if (arr1 == NULL || arr2 == NULL || arr1->size != arr2->size) {
+	if (arr == NULL) {
+		return 1;
+	}
+
+	if (cnt <= arr->cap) {
+		return 0;
+	}
+
+	return arr_resize(arr, arr->grow.exact ? cnt : (uint)MIN(grow_next(&arr->grow, arr->cap, cnt), (uint)-1));
+}
+
+int arr_shrink(arr_t *arr)
+{
+	if (arr == NULL) {
+		return 1;
+	}
+
+	uint cap = MAX(1, arr->cnt);
+	if (cap >= arr->cap) {
+		return 0;
+	}
+
+	size_t old_size = arr->cap * arr->size;
+	if (alloc_realloc_aligned(&arr->alloc, &arr->data, &old_size, cap * arr->size, arr->align)) {
+		log_error("cutils", "arr", NULL, "failed to shrink array");
+		return 1;
+	}
+
+	arr->cap = cap;
+
+	return 0;
+}
+
+void arr_set_grow(arr_t *arr, grow_t grow)
+{
+	if (arr == NULL) {
+		return;
+	}
+
+	arr->grow = grow;
+}
+
+void *arr_add(arr_t *arr, uint *id)
+{
+	if (arr == NULL) {
 		return NULL;
 	}
 
-	if (arr_init(arr, arr1->cnt + arr2->cnt, arr1->size, arr1->alloc) == NULL) {
+	if (arr->cnt >= arr->cap && arr_resize(arr, (uint)MIN(grow_next(&arr->grow, arr->cap, arr->cnt + 1), (uint)-1))) {
+		log_error("cutils", "arr", NULL, "failed to add element");
 		return NULL;
 	}
 
-	arr_add_all(arr, arr1);
-	arr_add_all(arr, arr2);
+	if (id) {
+		*id = arr->cnt;
+	}
 
-	return arr;
+	return (byte *)arr->data + (arr->cnt++) * arr->size;
 }
 
-arr_t *arr_merge_unique(arr_t *arr, const arr_t *arr1, const arr_t *arr2)
+void *arr_add_n(arr_t *arr, uint cnt, uint *id)
 {
-	if (arr1 == NULL || arr2 == NULL || arr1->size != arr2->size) {
+	if (arr == NULL) {
 		return NULL;
 	}
 
-	if (arr_init(arr, arr1->cnt + arr2->cnt, arr1->size, arr1->alloc) == NULL) {
+	if (cnt > (uint)-1 - arr->cnt) {
+		log_error("cutils", "arr", NULL, "too many elements: %d", cnt);
 		return NULL;
 	}
 
-	arr_add_unique(arr, arr1);
-	arr_add_unique(arr, arr2);
+	if (arr->cnt + cnt > arr->cap && arr_resize(arr, (uint)MIN(grow_next(&arr->grow, arr->cap, arr->cnt + cnt), (uint)-1))) {
+		log_error("cutils", "arr", NULL, "failed to add elements");
+		return NULL;
+	}
 
-	return arr;
+	if (id) {
+		*id = arr->cnt;
+	}
+
+	void *data = ELEM(arr->data, arr->cnt, arr->size);
+	arr->cnt += cnt;
+
+	return data;
 }
 
-arr_t *arr_sort(arr_t *arr, arr_cmp_cb cb, const void *priv)
+void *arr_insert_range(arr_t *arr, uint id, uint cnt, const void *values)
 {
 	if (arr == NULL) {
 		return NULL;
 	}
 
-	if (cb == NULL) {
-		return arr;
+	if (id > arr->cnt) {
+		log_error("cutils", "arr", NULL, "invalid id: %d", id);
+		return NULL;
 	}
 
-	void *v1;
-	uint i = 0;
-	arr_foreach(arr, i, v1)
-	{
-		void *v2;
-		uint j = i + 1;
-		arr_foreach(arr, j, v2)
-		{
-			if (cb(v1, v2, priv) > 0) {
-				mem_swap(v1, v2, arr->size);
-			}
-		}
+	if (arr_add_n(arr, cnt, NULL) == NULL) {
+		return NULL;
 	}
 
-	return arr;
+	uint indexed = arr->idx ? arr->idx->indexed : 0;
+
+	size_t tail = (size_t)(arr->cnt - cnt - id) * arr->size;
+	mem_move(ELEM(arr->data, id + cnt, arr->size), tail, ELEM(arr->data, id, arr->size), tail);
+
+	if (values) {
+		mem_copy(ELEM(arr->data, id, arr->size), cnt * arr->size, values, cnt * arr->size);
+	}
+
+	if (indexed > id) {
+		idx_rebuild(arr, values ? indexed + cnt : id);
+	} else if (values && indexed == id && arr->idx && idx_sync(arr, id + cnt)) {
+		idx_clear(arr);
+	}
+
+	return ELEM(arr->data, id, arr->size);
+}
+
+int arr_remove_range(arr_t *arr, uint id, uint cnt)
+{
+	if (arr == NULL) {
+		return 1;
+	}
+
+	if (id > arr->cnt || cnt > arr->cnt - id) {
+		log_error("cutils", "arr", NULL, "invalid range: %d:%d", id, cnt);
+		return 1;
+	}
+
+	uint indexed = arr->idx ? arr->idx->indexed : 0;
+
+	size_t tail = (size_t)(arr->cnt - cnt - id) * arr->size;
+	mem_move(ELEM(arr->data, id, arr->size), tail, ELEM(arr->data, id + cnt, arr->size), tail);
+	arr->cnt -= cnt;
+
+	if (indexed > id) {
+		idx_rebuild(arr, indexed >= id + cnt ? indexed - cnt : id);
+	}
+
+	return 0;
+}
+
+int arr_remove_swap(arr_t *arr, uint id)
+{
+	if (arr == NULL) {
+		return 1;
+	}
+
+	if (id >= arr->cnt) {
+		log_error("cutils", "arr", NULL, "invalid id: %d", id);
+		return 1;
+	}
+
+	arr_idx_t *idx = arr->idx;
+	uint last      = arr->cnt - 1;
+
+	if (idx && id < idx->indexed) {
+		idx_remove(arr, id);
+	}
+
+	if (idx && last != id && last < idx->indexed) {
+		idx_remove(arr, last);
+	}
+
+	if (last != id) {
+		mem_copy(ELEM(arr->data, id, arr->size), arr->size, ELEM(arr->data, last, arr->size), arr->size);
+	}
+
+	arr->cnt--;
+
+	if (idx) {
+		idx->indexed = MIN(idx->indexed, arr->cnt);
+		if (id < idx->indexed && idx_insert(arr, id)) {
+			idx_clear(arr);
+		}
+	}
+
+	return 0;
+}
+
+void *arr_get(const arr_t *arr, uint id)
+{
+	if (arr == NULL) {
+		return NULL;
+	}
+
+	if (id >= arr->cnt) {
+		log_error("cutils", "arr", NULL, "invalid id: %d", id);
+		return NULL;
+	}
+
+	return (byte *)arr->data + id * arr->size;
+}
+
+void *arr_set(arr_t *arr, uint id, const void *value)
+{
+	if (arr == NULL || value == NULL) {
+		return NULL;
+	}
+
+	void *dst = arr_get(arr, id);
+	if (dst == NULL) {
+		return NULL;
+	}
+
+	int indexed = arr->idx && id < arr->idx->indexed;
+	if (indexed) {
+		idx_remove(arr, id);
+	}
+
+	if (value) {
+		mem_copy(dst, arr->size, value, arr->size);
+	}
+
+	if (indexed && idx_insert(arr, id)) {
+		idx_clear(arr);
+	}
+
+	return dst;
+}
+
+int arr_addv(arr_t *arr, const void *value, uint *id)
+{
+	if (arr == NULL || value == NULL) {
+		return 1;
+	}
+
+	void *data = arr_add(arr, id);
+	if (data == NULL) {
+		return 1;
+	}
+
+	mem_copy(data, arr->size, value, arr->size);
+	idx_append(arr, arr->cnt - 1);
+
+	return 0;
+}
+
+int arr_addu(arr_t *arr, const void *value, uint *id)
+{
+	if (arr == NULL || value == NULL) {
+		return 1;
+	}
+
+	if (arr_find(arr, value, id) == 0) {
+		return 0;
+	}
+
+	return arr_addv(arr, value, id);
+}
+
+int arr_find(const arr_t *arr, const void *value, uint *id)
+{
+	if (arr == NULL || value == NULL) {
+		return 1;
+	}
+
+	uint from = 0;
+	if (arr->idx) {
+		if (idx_find(arr, value, id) == 0) {
+			return 0;
+		}
+		from = arr->idx->indexed;
+	}
+
+	for (uint i = from; i < arr->cnt; i++) {
+		if (arr->idx ? idx_eq(arr, arr_get(arr, i), value) : mem_cmp(arr_get(arr, i), value, arr->size) == 0) {
+			if (id) {
+				*id = i;
+			}
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+int arr_find_cmp(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id)
+{
+	if (arr == NULL || value == NULL || cb == NULL) {
+		return 1;
+	}
+
+	for (uint i = 0; i < arr->cnt; i++) {
+		if (cb(arr_get(arr, i), value, priv)) {
+			if (id) {
+				*id = i;
+			}
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+arr_t *arr_add_all(arr_t *arr, const arr_t *src)
+{
+	if (arr == NULL || src == NULL || arr->cap - arr->cnt < src->cnt || arr->size != src->size) {
+		return NULL;
+	}
+
+	mem_copy((byte *)arr->data + arr->cnt * arr->size, arr->cap * arr->size - arr->cnt * arr->size, src->data, src->cnt * src->size);
+
+	uint cnt = arr->cnt;
+	arr->cnt += src->cnt;
+
+	if (arr->idx && arr->idx->indexed == cnt && idx_sync(arr, arr->cnt)) {
+		idx_clear(arr);
+	}
+
+	return arr;
+}
+
+arr_t *arr_add_unique(arr_t *arr, const arr_t *src)
+{
+	if (arr == NULL || src == NULL || arr->size != src->size) {
+		return NULL;
+	}
+
+	int tmp = arr->idx == NULL && src->cnt > IDX_MIN_SIZE && arr_index(arr, NULL, NULL, NULL) == 0;
+
+	arr_t *ret = arr;
+	for (uint i = 0; i < src->cnt; i++) {
+		if (arr_addu(arr, arr_get(src, i), NULL)) {
+			ret = NULL;
+			break;
+		}
+	}
+
+	if (tmp) {
+		arr_unindex(arr);
+	}
+
+	return ret;
+}
+
+arr_t *arr_merge_all(arr_t *arr, const arr_t *arr1, const arr_t *arr2)
+{
+	if (arr1 == NULL || arr2 == NULL || arr1->size != arr2->size) {
+		return NULL;
+	}
+
+	if (arr_init(arr, arr1->cnt + arr2->cnt, arr1->size, arr1->alloc) == NULL) {
+		return NULL;
+	}
+
+	arr_add_all(arr, arr1);
+	arr_add_all(arr, arr2);
+
+	return arr;
+}
+
+arr_t *arr_merge_unique(arr_t *arr, const arr_t *arr1, const arr_t *arr2)
+{
+	if (arr1 == NULL || arr2 == NULL || arr1->size != arr2->size) {
+		return NULL;
+	}
+
+	if (arr_init(arr, arr1->cnt + arr2->cnt, arr1->size, arr1->alloc) == NULL) {
+		return NULL;
+	}
+
+	arr_add_unique(arr, arr1);
+	arr_add_unique(arr, arr2);
+
+	return arr;
+}
+
+int arr_lower_bound(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id)
+{
+	if (arr == NULL || value == NULL || cb == NULL) {
+		return 1;
+	}
+
+	uint lo = 0;
+	uint hi = arr->cnt;
+	while (lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if (cb(ELEM(arr->data, mid, arr->size), value, priv) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (id) {
+		*id = lo;
+	}
+
+	return 0;
+}
+
+int arr_upper_bound(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id)
+{
+	if (arr == NULL || value == NULL || cb == NULL) {
+		return 1;
+	}
+
+	uint lo = 0;
+	uint hi = arr->cnt;
+	while (lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if (cb(ELEM(arr->data, mid, arr->size), value, priv) <= 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (id) {
+		*id = lo;
+	}
+
+	return 0;
+}
+
+int arr_find_sorted(const arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id)
+{
+	uint lo;
+	if (arr_lower_bound(arr, value, cb, priv, &lo) || lo >= arr->cnt || cb(ELEM(arr->data, lo, arr->size), value, priv) != 0) {
+		return 1;
+	}
+
+	if (id) {
+		*id = lo;
+	}
+
+	return 0;
+}
+
+int arr_add_sorted(arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, uint *id)
+{
+	uint pos;
+	if (arr_upper_bound(arr, value, cb, priv, &pos)) {
+		return 1;
+	}
+
+	if (arr_add(arr, NULL) == NULL) {
+		return 1;
+	}
+
+	uint indexed = arr->idx ? arr->idx->indexed : 0;
+
+	size_t tail = (arr->cnt - 1 - pos) * arr->size;
+	mem_move(ELEM(arr->data, pos + 1, arr->size), tail, ELEM(arr->data, pos, arr->size), tail);
+	mem_copy(ELEM(arr->data, pos, arr->size), arr->size, value, arr->size);
+
+	if (indexed == pos) {
+		idx_append(arr, pos);
+	} else if (indexed > pos) {
+		idx_rebuild(arr, indexed + 1);
+	}
+
+	if (id) {
+		*id = pos;
+	}
+
+	return 0;
+}
+
+#define SORTED_LEFT   (1 << 0)
+#define SORTED_RIGHT  (1 << 1)
+#define SORTED_BOTH   (1 << 2)
+#define SORTED_ALL    (1 << 3)
+#define SORTED_UNIQUE (1 << 4)
+
+static void sorted_push(arr_t *arr, const void *value, arr_cmp_cb cb, const void *priv, int flags)
+{
+	if (flags & SORTED_UNIQUE && arr->cnt > 0 && cb(ELEM(arr->data, arr->cnt - 1, arr->size), value, priv) == 0) {
+		return;
+	}
+
+	mem_copy(ELEM(arr->data, arr->cnt++, arr->size), arr->size, value, arr->size);
+}
+
+static void sorted_tail(arr_t *arr, const arr_t *src, uint from, arr_cmp_cb cb, const void *priv, int flags)
+{
+	size_t size = src->size;
+
+	if (flags & SORTED_UNIQUE) {
+		for (uint i = from; i < src->cnt; i++) {
+			sorted_push(arr, ELEM(src->data, i, size), cb, priv, flags);
+		}
+		return;
+	}
+
+	mem_copy(ELEM(arr->data, arr->cnt, size), (src->cnt - from) * size, ELEM(src->data, from, size), (src->cnt - from) * size);
+	arr->cnt += src->cnt - from;
+}
+
+static arr_t *sorted_combine(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv, int flags)
+{
+	if (arr1 == NULL || arr2 == NULL || cb == NULL || arr1->size != arr2->size) {
+		return NULL;
+	}
+
+	if (arr_init(arr, MAX(1, arr1->cnt + arr2->cnt), arr1->size, arr1->alloc) == NULL) {
+		return NULL;
+	}
+
+	size_t size = arr1->size;
+	uint i	    = 0;
+	uint j	    = 0;
+
+	while (i < arr1->cnt && j < arr2->cnt) {
+		const void *a = ELEM(arr1->data, i, size);
+		const void *b = ELEM(arr2->data, j, size);
+
+		int cmp = cb(a, b, priv);
+		if (cmp < 0) {
+			if (flags & SORTED_LEFT) {
+				sorted_push(arr, a, cb, priv, flags);
+			}
+			i++;
+		} else if (cmp > 0) {
+			if (flags & SORTED_RIGHT) {
+				sorted_push(arr, b, cb, priv, flags);
+			}
+			j++;
+		} else if (flags & SORTED_ALL) {
+			sorted_push(arr, a, cb, priv, flags);
+			i++;
+		} else {
+			if (flags & SORTED_BOTH) {
+				sorted_push(arr, a, cb, priv, flags);
+			}
+			i++;
+			j++;
+		}
+	}
+
+	if (flags & SORTED_LEFT) {
+		sorted_tail(arr, arr1, i, cb, priv, flags);
+	}
+
+	if (flags & SORTED_RIGHT) {
+		sorted_tail(arr, arr2, j, cb, priv, flags);
+	}
+
+	return arr;
+}
+
+arr_t *arr_merge_sorted(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv)
+{
+	return sorted_combine(arr, arr1, arr2, cb, priv, SORTED_LEFT | SORTED_RIGHT | SORTED_ALL);
+}
+
+arr_t *arr_union(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv)
+{
+	return sorted_combine(arr, arr1, arr2, cb, priv, SORTED_LEFT | SORTED_RIGHT | SORTED_BOTH | SORTED_UNIQUE);
+}
+
+arr_t *arr_intersect(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv)
+{
+	return sorted_combine(arr, arr1, arr2, cb, priv, SORTED_BOTH);
+}
+
+arr_t *arr_diff(arr_t *arr, const arr_t *arr1, const arr_t *arr2, arr_cmp_cb cb, const void *priv)
+{
+	return sorted_combine(arr, arr1, arr2, cb, priv, SORTED_LEFT);
+}
+
+#define SORT_INSERTION 16
+
+static void sort_insertion(byte *base, size_t n, size_t size, arr_cmp_cb cb, const void *priv)
+{
+	for (size_t i = 1; i < n; i++) {
+		for (size_t j = i; j > 0 && cb(ELEM(base, j - 1, size), ELEM(base, j, size), priv) > 0; j--) {
+			mem_swap(ELEM(base, j - 1, size), ELEM(base, j, size), size);
+		}
+	}
+}
+
+static void sort_sift(byte *base, size_t root, size_t n, size_t size, arr_cmp_cb cb, const void *priv)
+{
+	for (size_t child = 2 * root + 1; child < n; child = 2 * root + 1) {
+		if (child + 1 < n && cb(ELEM(base, child, size), ELEM(base, child + 1, size), priv) < 0) {
+			child++;
+		}
+
+		if (cb(ELEM(base, root, size), ELEM(base, child, size), priv) >= 0) {
+			return;
+		}
+
+		mem_swap(ELEM(base, root, size), ELEM(base, child, size), size);
+		root = child;
+	}
+}
+
+static void sort_heap(byte *base, size_t n, size_t size, arr_cmp_cb cb, const void *priv)
+{
+	for (size_t i = n / 2; i-- > 0;) {
+		sort_sift(base, i, n, size, cb, priv);
+	}
+
+	for (size_t i = n; i-- > 1;) {
+		mem_swap(base, ELEM(base, i, size), size);
+		sort_sift(base, 0, i, size, cb, priv);
+	}
+}
+
+static void sort_median(byte *base, size_t n, size_t size, arr_cmp_cb cb, const void *priv)
+{
+	byte *a = ELEM(base, 1, size);
+	byte *b = ELEM(base, n / 2, size);
+	byte *c = ELEM(base, n - 1, size);
+
+	if (cb(a, b, priv) > 0) {
+		mem_swap(a, b, size);
+	}
+	if (cb(b, c, priv) > 0) {
+		mem_swap(b, c, size);
+		if (cb(a, b, priv) > 0) {
+			mem_swap(a, b, size);
+		}
+	}
+
+	mem_swap(base, b, size);
+}
+
+static void sort_intro(byte *base, size_t n, size_t size, arr_cmp_cb cb, const void *priv, int depth)
+{
+	while (n > SORT_INSERTION) {
+		if (depth-- == 0) {
+			sort_heap(base, n, size, cb, priv);
+			return;
+		}
+
+		sort_median(base, n, size, cb, priv);
+
+		size_t i = 1;
+		size_t j = n - 1;
+		for (;;) {
+			while (i <= j && cb(ELEM(base, i, size), base, priv) < 0) {
+				i++;
+			}
+			while (i <= j && cb(ELEM(base, j, size), base, priv) > 0) {
+				j--;
+			}
+			if (i >= j) {
+				break;
+			}
+			mem_swap(ELEM(base, i, size), ELEM(base, j, size), size);
+			i++;
+			j--;
+		}
+
+		mem_swap(base, ELEM(base, j, size), size);
+
+		size_t left  = j;
+		size_t right = n - j - 1;
+		if (left < right) {
+			sort_intro(base, left, size, cb, priv, depth);
+			base = ELEM(base, j + 1, size);
+			n    = right;
+		} else {
+			sort_intro(ELEM(base, j + 1, size), right, size, cb, priv, depth);
+			n = left;
+		}
+	}
+
+	sort_insertion(base, n, size, cb, priv);
+}
+
+static void sort(void *base, size_t n, size_t size, arr_cmp_cb cb, const void *priv)
+{
+	int depth = 0;
+	for (size_t i = n; i > 1; i >>= 1) {
+		depth += 2;
+	}
+
+	sort_intro(base, n, size, cb, priv, depth);
+}
+
+arr_t *arr_sort(arr_t *arr, arr_cmp_cb cb, const void *priv)
+{
+	if (arr == NULL) {
+		return NULL;
+	}
+
+	uint indexed = idx_clear(arr);
+
+	if (cb == NULL) {
+		return idx_sorted(arr, indexed);
+	}
+
+	sort(arr->data, arr->cnt, arr->size, cb, priv);
+
+	return idx_sorted(arr, indexed);
+}
+
+static void sort_merge(const byte *src, byte *dst, size_t lo, size_t mid, size_t hi, size_t size, arr_cmp_cb cb, const void *priv)
+{
+	size_t i = lo;
+	size_t j = mid;
+	size_t k = lo;
+
+	while (i < mid && j < hi) {
+		if (cb(ELEM(src, i, size), ELEM(src, j, size), priv) <= 0) {
+			mem_copy(ELEM(dst, k++, size), size, ELEM(src, i++, size), size);
+		} else {
+			mem_copy(ELEM(dst, k++, size), size, ELEM(src, j++, size), size);
+		}
+	}
+
+	if (i < mid) {
+		mem_copy(ELEM(dst, k, size), (mid - i) * size, ELEM(src, i, size), (mid - i) * size);
+		k += mid - i;
+	}
+
+	if (j < hi) {
+		mem_copy(ELEM(dst, k, size), (hi - j) * size, ELEM(src, j, size), (hi - j) * size);
+	}
+}
+
+arr_t *arr_sort_stable(arr_t *arr, arr_cmp_cb cb, const void *priv)
+{
+	if (arr == NULL) {
+		return NULL;
+	}
+
+	uint indexed = idx_clear(arr);
+
+	if (cb == NULL || arr->cnt < 2) {
+		return idx_sorted(arr, indexed);
+	}
+
+	size_t n    = arr->cnt;
+	size_t size = arr->size;
+
+	for (size_t lo = 0; lo < n; lo += SORT_INSERTION) {
+		sort_insertion(ELEM(arr->data, lo, size), n - lo < SORT_INSERTION ? n - lo : SORT_INSERTION, size, cb, priv);
+	}
+
+	if (n <= SORT_INSERTION) {
+		return idx_sorted(arr, indexed);
+	}
+
+	byte *tmp = alloc_alloc(&arr->alloc, n * size);
+	if (tmp == NULL) {
+		log_error("cutils", "arr", NULL, "failed to allocate sort buffer");
+		return NULL;
+	}
+
+	byte *src = arr->data;
+	byte *dst = tmp;
+	for (size_t width = SORT_INSERTION; width < n; width *= 2) {
+		for (size_t lo = 0; lo < n; lo += 2 * width) {
+			size_t mid = lo + width < n ? lo + width : n;
+			size_t hi  = lo + 2 * width < n ? lo + 2 * width : n;
+			sort_merge(src, dst, lo, mid, hi, size, cb, priv);
+		}
+
+		byte *t = src;
+		src	= dst;
+		dst	= t;
+	}
+
+	if (src != arr->data) {
+		mem_copy(arr->data, n * size, src, n * size);
+	}
+
+	alloc_free(&arr->alloc, tmp, n * size);
+
+	return idx_sorted(arr, indexed);
+}
+
+#define SORT_PAR_MIN	 16384
+#define SORT_PAR_THREADS 64
+
+typedef struct sort_par_s sort_par_t;
+
+typedef struct sort_part_s {
+	sort_par_t *par;
+	uint i;
+} sort_part_t;
+
+struct sort_par_s {
+	byte *bufs[2];
+	size_t n;
+	size_t size;
+	arr_cmp_cb cb;
+	const void *priv;
+	uint parts;
+	sort_part_t args[SORT_PAR_THREADS];
+	thread_t threads[SORT_PAR_THREADS];
+	int started[SORT_PAR_THREADS];
+};
+
+static void sort_thread(void *priv);
+
+// part i starts the parts it will later merge with, sorts its own range and then merges up the tree until it is the
+// right half of a merge, so every thread is created once and reused for all levels
+static void sort_part(sort_par_t *par, uint i)
+{
+	size_t n    = par->n;
+	uint parts  = par->parts;
+	size_t size = par->size;
+
+	uint top = 1;
+	while (top < parts && i % (2 * top) == 0) {
+		top *= 2;
+	}
+
+	for (uint width = top / 2; width > 0; width /= 2) {
+		par->args[i + width]	= (sort_part_t){.par = par, .i = i + width};
+		par->started[i + width] = thread_create(&par->threads[i + width], sort_thread, &par->args[i + width]) == 0;
+	}
+
+	size_t lo = n * i / parts;
+	sort(ELEM(par->bufs[0], lo, size), n * (i + 1) / parts - lo, size, par->cb, par->priv);
+
+	uint level = 0;
+	for (uint width = 1; width < top; width *= 2, level++) {
+		if (par->started[i + width]) {
+			thread_join(&par->threads[i + width]);
+		} else {
+			sort_part(par, i + width);
+		}
+
+		size_t mid = n * (i + width) / parts;
+		size_t hi  = n * (i + 2 * width) / parts;
+		sort_merge(par->bufs[level & 1], par->bufs[(level + 1) & 1], lo, mid, hi, size, par->cb, par->priv);
+	}
+}
+
+static void sort_thread(void *priv)
+{
+	sort_part_t *part = priv;
+	sort_part(part->par, part->i);
+}
+
+arr_t *arr_sort_par(arr_t *arr, arr_cmp_cb cb, const void *priv, uint threads)
+{
+	if (arr == NULL) {
+		return NULL;
+	}
+
+	uint indexed = idx_clear(arr);
+
+	if (cb == NULL) {
+		return idx_sorted(arr, indexed);
+	}
+
+	if (threads == 0) {
+		threads = thread_cpus();
+	}
+
+	uint parts = 1;
+	while (parts * 2 <= threads && parts * 2 <= SORT_PAR_THREADS && arr->cnt / (parts * 2) >= SORT_PAR_MIN) {
+		parts *= 2;
+	}
+
+	if (parts == 1) {
+		sort(arr->data, arr->cnt, arr->size, cb, priv);
+		return idx_sorted(arr, indexed);
+	}
+
+	size_t n    = arr->cnt;
+	size_t size = arr->size;
+
+	byte *tmp = alloc_alloc(&arr->alloc, n * size);
+	if (tmp == NULL) {
+		log_error("cutils", "arr", NULL, "failed to allocate sort buffer");
+		return NULL;
+	}
+
+	sort_par_t par = {
+		.bufs  = {arr->data, tmp},
+		.n     = n,
+		.size  = size,
+		.cb    = cb,
+		.priv  = priv,
+		.parts = parts,
+	};
+
+	sort_part(&par, 0);
+
+	uint levels = 0;
+	for (uint width = 1; width < parts; width *= 2) {
+		levels++;
+	}
+
+	if (levels & 1) {
+		mem_copy(arr->data, n * size, tmp, n * size);
+	}
+
+	alloc_free(&arr->alloc, tmp, n * size);
+
+	return idx_sorted(arr, indexed);
+}
+
+typedef struct sort_idx_s {
+	const arr_t *arr;
+	arr_cmp_cb cb;
+	const void *priv;
+} sort_idx_t;
+
+static int sort_idx_cmp(const void *id1, const void *id2, const void *priv)
+{
+	const sort_idx_t *ctx = priv;
+	return ctx->cb(ELEM(ctx->arr->data, *(const uint *)id1, ctx->arr->size), ELEM(ctx->arr->data, *(const uint *)id2, ctx->arr->size), ctx->priv);
+}
+
+int arr_sort_idx(const arr_t *arr, arr_cmp_cb cb, const void *priv, uint *ids)
+{
+	if (arr == NULL || cb == NULL || ids == NULL) {
+		return 1;
+	}
+
+	for (uint i = 0; i < arr->cnt; i++) {
+		ids[i] = i;
+	}
+
+	sort_idx_t ctx = {.arr = arr, .cb = cb, .priv = priv};
+	sort(ids, arr->cnt, sizeof(uint), sort_idx_cmp, &ctx);
+
+	return 0;
+}
+
+arr_t *arr_sort_ind(arr_t *arr, arr_cmp_cb cb, const void *priv)
+{
+	if (arr == NULL) {
+		return NULL;
+	}
+
+	uint indexed = idx_clear(arr);
+
+	if (cb == NULL || arr->cnt < 2) {
+		return idx_sorted(arr, indexed);
+	}
+
+	size_t ids_size = arr->cnt * sizeof(uint);
+	uint *ids	= alloc_alloc(&arr->alloc, ids_size + arr->size);
+	if (ids == NULL) {
+		log_error("cutils", "arr", NULL, "failed to allocate sort buffer");
+		return NULL;
+	}
+
+	byte *tmp = (byte *)ids + ids_size;
+
+	arr_sort_idx(arr, cb, priv, ids);
+
+	for (uint start = 0; start < arr->cnt; start++) {
+		if (ids[start] == start) {
+			continue;
+		}
+
+		mem_copy(tmp, arr->size, ELEM(arr->data, start, arr->size), arr->size);
+
+		uint cur = start;
+		while (ids[cur] != start) {
+			uint src = ids[cur];
+			mem_copy(ELEM(arr->data, cur, arr->size), arr->size, ELEM(arr->data, src, arr->size), arr->size);
+			ids[cur] = cur;
+			cur	 = src;
+		}
+
+		mem_copy(ELEM(arr->data, cur, arr->size), arr->size, tmp, arr->size);
+		ids[cur] = cur;
+	}
+
+	alloc_free(&arr->alloc, ids, ids_size + arr->size);
+
+	return idx_sorted(arr, indexed);
+}
+
+static u64 radix_key(const byte *elem, size_t len, int sign)
+{
+	u64 key = 0;
+	switch (len) {
+	case sizeof(u8): key = *elem; break;
+	case sizeof(u16): {
+		u16 val;
+		mem_copy(&val, sizeof(val), elem, sizeof(val));
+		key = val;
+		break;
+	}
+	case sizeof(u32): {
+		u32 val;
+		mem_copy(&val, sizeof(val), elem, sizeof(val));
+		key = val;
+		break;
+	}
+	default: mem_copy(&key, sizeof(key), elem, sizeof(key)); break;
+	}
+
+	if (sign) {
+		key ^= (u64)1 << (len * 8 - 1);
+	}
+
+	return key;
+}
+
+arr_t *arr_sort_radix(arr_t *arr, size_t off, size_t len, int sign)
+{
+	if (arr == NULL) {
+		return NULL;
+	}
+
+	uint indexed = idx_clear(arr);
+
+	if ((len != sizeof(u8) && len != sizeof(u16) && len != sizeof(u32) && len != sizeof(u64)) || off + len > arr->size) {
+		log_error("cutils", "arr", NULL, "invalid radix key: %zu:%zu", off, len);
+		return NULL;
+	}
+
+	if (arr->cnt < 2) {
+		return idx_sorted(arr, indexed);
+	}
+
+	size_t n    = arr->cnt;
+	size_t size = arr->size;
+
+	byte *tmp = alloc_alloc(&arr->alloc, n * size);
+	if (tmp == NULL) {
+		log_error("cutils", "arr", NULL, "failed to allocate sort buffer");
+		return NULL;
+	}
+
+	byte *src = arr->data;
+	byte *dst = tmp;
+	for (size_t pass = 0; pass < len; pass++) {
+		size_t cnts[256] = {0};
+		for (size_t i = 0; i < n; i++) {
+			cnts[(radix_key(ELEM(src, i, size) + off, len, sign) >> (pass * 8)) & 0xff]++;
+		}
+
+		int skip = 0;
+		for (int d = 0; d < 256 && !skip; d++) {
+			skip = cnts[d] == n;
+		}
+
+		if (skip) {
+			continue;
+		}
+
+		size_t pos = 0;
+		for (int d = 0; d < 256; d++) {
+			size_t cnt = cnts[d];
+			cnts[d]	   = pos;
+			pos += cnt;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			const byte *elem = ELEM(src, i, size);
+			size_t d	 = (radix_key(elem + off, len, sign) >> (pass * 8)) & 0xff;
+			mem_copy(ELEM(dst, cnts[d]++, size), size, elem, size);
+		}
+
+		byte *t = src;
+		src	= dst;
+		dst	= t;
+	}
+
+	if (src != arr->data) {
+		mem_copy(arr->data, n * size, src, n * size);
+	}
+
+	alloc_free(&arr->alloc, tmp, n * size);
+
+	return idx_sorted(arr, indexed);
 }
 
 size_t arr_print(const arr_t *arr, arr_print_cb cb, dst_t dst, const void *priv)
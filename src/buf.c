@@ -10,12 +10,17 @@ static int add_overflows(size_t a, size_t b)
 }
 
 void *buf_init(buf_t *buf, size_t size, alloc_t alloc)
+{
+	return buf_init_a(buf, size, 0, alloc);
+}
+
+void *buf_init_a(buf_t *buf, size_t size, size_t align, alloc_t alloc)
 {
 	if (buf == NULL) {
 		return NULL;
 	}
 
-	void *data = alloc_alloc(&alloc, size);
+	void *data = alloc_alloc_aligned(&alloc, size, align);
 	if (data == NULL) {
 		log_error("cutils", "buf", NULL, "failed to allocate data");
 		return NULL;
@@ -24,7 +29,9 @@ void *buf_init(buf_t *buf, size_t size, alloc_t alloc)
 	buf->data  = data;
 	buf->size  = size;
 	buf->used  = 0;
+	buf->align = align;
 	buf->alloc = alloc;
+	buf->grow  = (grow_t){0};
 	return buf;
 }
 
@@ -34,7 +41,7 @@ void buf_free(buf_t *buf)
 		return;
 	}
 
-	alloc_free(&buf->alloc, buf->data, buf->size);
+	alloc_free_aligned(&buf->alloc, buf->data, buf->size, buf->align);
 	buf->data = NULL;
 	buf->size = 0;
 	buf->used = 0;
@@ -63,7 +70,7 @@ int buf_resize(buf_t *buf, size_t size)
 		return 0;
 	}
 
-	if (alloc_realloc(&buf->alloc, &buf->data, &buf->size, size)) {
+	if (alloc_realloc_aligned(&buf->alloc, &buf->data, &buf->size, size, buf->align)) {
 		log_error("cutils", "buf", NULL, "failed to resize buffer");
 		return 1;
 	}
@@ -71,6 +78,52 @@ int buf_resize(buf_t *buf, size_t size)
 	return 0;
 }
 
+static int ensure(buf_t *buf, size_t used)
+{
+	return used > buf->size && buf_resize(buf, grow_next(&buf->grow, buf->size, used));
+}
+
+int buf_reserve(buf_t *buf, size_t size)
+{
+	if (buf == NULL) {
+		return 1;
+	}
+
+	if (size <= buf->size) {
+		return 0;
+	}
+
+	return buf_resize(buf, buf->grow.exact ? size : grow_next(&buf->grow, buf->size, size));
+}
+
+int buf_shrink(buf_t *buf)
+{
+	if (buf == NULL) {
+		return 1;
+	}
+
+	size_t size = buf->used ? buf->used : 1;
+	if (size >= buf->size) {
+		return 0;
+	}
+
+	if (alloc_realloc_aligned(&buf->alloc, &buf->data, &buf->size, size, buf->align)) {
+		log_error("cutils", "buf", NULL, "failed to shrink buffer");
+		return 1;
+	}
+
+	return 0;
+}
+
+void buf_set_grow(buf_t *buf, grow_t grow)
+{
+	if (buf == NULL) {
+		return;
+	}
+
+	buf->grow = grow;
+}
+
 int buf_set(buf_t *buf, size_t off, size_t size, const void *data)
 {
 	if (buf == NULL) {
@@ -104,7 +157,7 @@ int buf_add(buf_t *buf, size_t size, const void *data, size_t *off)
 	}
 
 	size_t used = buf->used + size;
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -132,7 +185,7 @@ int buf_write_le(buf_t *buf, const void *val, size_t size)
 	}
 
 	size_t used = buf->used + size;
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -150,7 +203,7 @@ int buf_write_u8le(buf_t *buf, u8 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -168,7 +221,7 @@ int buf_write_u16le(buf_t *buf, u16 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -186,7 +239,7 @@ int buf_write_u32le(buf_t *buf, u32 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -204,7 +257,7 @@ int buf_write_u64le(buf_t *buf, u64 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -222,7 +275,7 @@ int buf_write_be(buf_t *buf, const void *val, size_t size)
 	}
 
 	size_t used = buf->used + size;
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -240,7 +293,7 @@ int buf_write_u8be(buf_t *buf, u8 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -258,7 +311,7 @@ int buf_write_u16be(buf_t *buf, u16 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -276,7 +329,7 @@ int buf_write_u32be(buf_t *buf, u32 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -294,7 +347,7 @@ int buf_write_u64be(buf_t *buf, u64 val)
 	}
 
 	size_t used = buf->used + sizeof(val);
-	if (used > buf->size && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (ensure(buf, used)) {
 		return 1;
 	}
 
@@ -560,7 +613,7 @@ buf_t *buf_replace(buf_t *buf, size_t off, const void *data, size_t old_len, siz
 	}
 
 	size_t used = buf->used - old_len + new_len;
-	if (new_len > old_len && (used > (size_t)-1 / 2 || buf_resize(buf, used * 2))) {
+	if (new_len > old_len && ensure(buf, used)) {
 		return NULL;
 	}
 
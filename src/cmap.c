@@ -0,0 +1,185 @@
+#include "cmap.h"
+
+#include "hash.h"
+#include "hmap.h"
+#include "log.h"
+#include "mem.h"
+#include "sync.h"
+
+#define CMAP_LINE 64
+
+struct cmap_stripe_s {
+	lock_t lock;
+	hmap_t map;
+	byte pad[CMAP_LINE - (sizeof(lock_t) + sizeof(hmap_t)) % CMAP_LINE];
+};
+
+static cmap_stripe_t *get_stripe(const cmap_t *map, const void *key, size_t ksize)
+{
+	u64 hash = map->hash ? map->hash(key, ksize, map->priv) : hash_bytes(key, ksize, map->seed);
+	return &map->stripes[(hash >> 32) & (map->cnt - 1)];
+}
+
+cmap_t *cmap_init(cmap_t *map, uint stripes, alloc_t alloc)
+{
+	if (map == NULL || stripes == 0) {
+		return NULL;
+	}
+
+	uint cnt = 1;
+	while (cnt < stripes) {
+		cnt *= 2;
+	}
+
+	map->stripes = alloc_alloc_aligned(&alloc, cnt * sizeof(cmap_stripe_t), CMAP_LINE);
+	if (map->stripes == NULL) {
+		log_error("cutils", "cmap", NULL, "failed to allocate stripes");
+		return NULL;
+	}
+
+	map->cnt   = cnt;
+	map->seed  = hash_seed();
+	map->hash  = NULL;
+	map->priv  = NULL;
+	map->alloc = alloc;
+
+	mem_shards(1);
+
+	for (uint i = 0; i < cnt; i++) {
+		map->stripes[i].lock = (lock_t){0};
+		if (hmap_init(&map->stripes[i].map, 0, alloc) == NULL) {
+			map->cnt = i;
+			cmap_free(map);
+			return NULL;
+		}
+	}
+
+	return map;
+}
+
+void cmap_free(cmap_t *map)
+{
+	if (map == NULL || map->stripes == NULL) {
+		return;
+	}
+
+	for (uint i = 0; i < map->cnt; i++) {
+		hmap_free(&map->stripes[i].map);
+	}
+
+	alloc_free_aligned(&map->alloc, map->stripes, map->cnt * sizeof(cmap_stripe_t), CMAP_LINE);
+	map->stripes = NULL;
+	map->cnt     = 0;
+
+	mem_shards(0);
+}
+
+int cmap_set_hash(cmap_t *map, hash_cb hash, hash_eq_cb eq, const void *priv)
+{
+	if (map == NULL || map->stripes == NULL) {
+		return 1;
+	}
+
+	if (cmap_count(map) > 0) {
+		log_error("cutils", "cmap", NULL, "hash can only be changed on an empty map");
+		return 1;
+	}
+
+	for (uint i = 0; i < map->cnt; i++) {
+		hmap_set_hash(&map->stripes[i].map, hash, eq, priv);
+	}
+
+	map->hash = hash;
+	map->priv = priv;
+
+	return 0;
+}
+
+int cmap_set(cmap_t *map, const void *key, size_t ksize, void *value)
+{
+	if (map == NULL || map->stripes == NULL || key == NULL) {
+		return 1;
+	}
+
+	cmap_stripe_t *stripe = get_stripe(map, key, ksize);
+
+	lock_acquire(&stripe->lock);
+	int ret = hmap_set(&stripe->map, key, ksize, value);
+	lock_release(&stripe->lock);
+
+	return ret;
+}
+
+int cmap_get(const cmap_t *map, const void *key, size_t ksize, void **value)
+{
+	if (map == NULL || map->stripes == NULL || key == NULL) {
+		return 1;
+	}
+
+	const cmap_stripe_t *stripe = get_stripe(map, key, ksize);
+
+	lock_acquire((lock_t *)&stripe->lock);
+	int ret = hmap_get(&stripe->map, key, ksize, value);
+	lock_release((lock_t *)&stripe->lock);
+
+	return ret;
+}
+
+int cmap_remove(cmap_t *map, const void *key, size_t ksize, void **value)
+{
+	if (map == NULL || map->stripes == NULL || key == NULL) {
+		return 1;
+	}
+
+	cmap_stripe_t *stripe = get_stripe(map, key, ksize);
+
+	lock_acquire(&stripe->lock);
+	int ret = hmap_remove(&stripe->map, key, ksize, value);
+	lock_release(&stripe->lock);
+
+	return ret;
+}
+
+int cmap_compute(cmap_t *map, const void *key, size_t ksize, cmap_compute_cb cb, void *priv, void **value)
+{
+	if (map == NULL || map->stripes == NULL || key == NULL || cb == NULL) {
+		return 1;
+	}
+
+	cmap_stripe_t *stripe = get_stripe(map, key, ksize);
+
+	lock_acquire(&stripe->lock);
+
+	void *val;
+	int ret = 0;
+	if (hmap_get(&stripe->map, key, ksize, &val)) {
+		val = cb(key, ksize, priv);
+		ret = val == NULL || hmap_set(&stripe->map, key, ksize, val);
+	}
+
+	lock_release(&stripe->lock);
+
+	if (ret == 0 && value) {
+		*value = val;
+	}
+
+	return ret;
+}
+
+uint cmap_count(const cmap_t *map)
+{
+	if (map == NULL || map->stripes == NULL) {
+		return 0;
+	}
+
+	uint cnt = 0;
+	for (uint i = 0; i < map->cnt; i++) {
+		const cmap_stripe_t *stripe = &map->stripes[i];
+
+		lock_acquire((lock_t *)&stripe->lock);
+		cnt += stripe->map.cnt;
+		lock_release((lock_t *)&stripe->lock);
+	}
+
+	return cnt;
+}
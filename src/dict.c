@@ -1,17 +1,32 @@
 #include "dict.h"
 
+#include "log.h"
 #include "mem.h"
 
 #define DICT_MAX_LOAD	   0.75f
 #define DICT_RESIZE_FACTOR 2
 
-dict_t *dict_init(dict_t *map, int capacity)
+static struct bucket *alloc_buckets(dict_t *map, int capacity)
 {
-	if (map == NULL) {
+	struct bucket *buckets = alloc_alloc(&map->alloc, capacity * sizeof(struct bucket));
+	if (buckets == NULL) {
+		log_error("cutils", "dict", NULL, "failed to allocate buckets");
+		return NULL;
+	}
+
+	mem_set(buckets, 0, capacity * sizeof(struct bucket));
+
+	return buckets;
+}
+
+dict_t *dict_init(dict_t *map, int capacity, alloc_t alloc)
+{
+	if (map == NULL || capacity <= 0) {
 		return NULL;
 	}
 
-	map->buckets = mem_calloc(capacity, sizeof(struct bucket));
+	map->alloc   = alloc;
+	map->buckets = alloc_buckets(map, capacity);
 	if (map->buckets == NULL) {
 		return NULL;
 	}
@@ -19,83 +34,168 @@ dict_t *dict_init(dict_t *map, int capacity)
 	map->capacity = capacity;
 	map->count    = 0;
 	map->first    = NULL;
-	map->last     = (struct bucket *)&map->first;
+	map->last     = NULL;
+	map->seed     = hash_seed();
+	map->hash     = NULL;
+	map->eq	      = NULL;
+	map->priv     = NULL;
 
 	return map;
 }
 
-void dict_free(dict_t *map)
+int dict_set_hash(dict_t *map, hash_cb hash, hash_eq_cb eq, const void *priv)
 {
 	if (map == NULL) {
+		return 1;
+	}
+
+	if (map->count > 0) {
+		log_error("cutils", "dict", NULL, "hash can only be changed on an empty dict");
+		return 1;
+	}
+
+	map->hash = hash;
+	map->eq	  = eq;
+	map->priv = priv;
+
+	return 0;
+}
+
+void dict_free(dict_t *map)
+{
+	if (map == NULL || map->buckets == NULL) {
 		return;
 	}
 
-	mem_free(map->buckets, map->capacity * sizeof(struct bucket));
+	alloc_free(&map->alloc, map->buckets, map->capacity * sizeof(struct bucket));
+	map->buckets  = NULL;
+	map->capacity = 0;
+	map->count    = 0;
+	map->first    = NULL;
+	map->last     = NULL;
 }
 
-static struct bucket *resize_entry(dict_t *map, struct bucket *old_entry)
+void dict_reset(dict_t *map)
 {
-	u32 index = old_entry->hash % map->capacity;
-	for (;;) {
-		struct bucket *entry = &map->buckets[index];
+	if (map == NULL || map->buckets == NULL) {
+		return;
+	}
 
-		if (entry->key == NULL) {
-			*entry = *old_entry;
-			return entry;
-		}
+	mem_set(map->buckets, 0, map->capacity * sizeof(struct bucket));
+	map->count = 0;
+	map->first = NULL;
+	map->last  = NULL;
+}
 
-		index = (index + 1) % map->capacity;
+static void link_entry(dict_t *map, struct bucket *entry)
+{
+	entry->next = NULL;
+	entry->prev = map->last;
+
+	if (map->last) {
+		map->last->next = entry;
+	} else {
+		map->first = entry;
+	}
+
+	map->last = entry;
+}
+
+static void relink_entry(dict_t *map, struct bucket *entry)
+{
+	if (entry->prev) {
+		entry->prev->next = entry;
+	} else {
+		map->first = entry;
+	}
+
+	if (entry->next) {
+		entry->next->prev = entry;
+	} else {
+		map->last = entry;
 	}
 }
 
-static void dict_resize(dict_t *map)
+static void unlink_entry(dict_t *map, struct bucket *entry)
 {
+	if (entry->prev) {
+		entry->prev->next = entry->next;
+	} else {
+		map->first = entry->next;
+	}
+
+	if (entry->next) {
+		entry->next->prev = entry->prev;
+	} else {
+		map->last = entry->prev;
+	}
+}
+
+static int dict_resize(dict_t *map, int capacity)
+{
+	struct bucket *buckets = alloc_buckets(map, capacity);
+	if (buckets == NULL) {
+		return 1;
+	}
+
 	struct bucket *old_buckets = map->buckets;
 	int old_capacity	   = map->capacity;
+	struct bucket *entry	   = map->first;
 
-	map->capacity *= DICT_RESIZE_FACTOR;
-	map->buckets = mem_calloc(map->capacity, sizeof(struct bucket));
+	map->buckets  = buckets;
+	map->capacity = capacity;
+	map->first    = NULL;
+	map->last     = NULL;
+
+	for (; entry != NULL; entry = entry->next) {
+		u32 index = entry->hash % map->capacity;
+		while (map->buckets[index].key != NULL) {
+			index = (index + 1) % map->capacity;
+		}
 
-	map->last = (struct bucket *)&map->first;
+		struct bucket *new_entry = &map->buckets[index];
+		*new_entry		 = *entry;
+		link_entry(map, new_entry);
+	}
 
-	do {
-		map->last->next = resize_entry(map, map->last->next);
-		map->last	= map->last->next;
-	} while (map->last->next != NULL);
+	alloc_free(&map->alloc, old_buckets, old_capacity * sizeof(struct bucket));
 
-	mem_free(old_buckets, old_capacity * sizeof(struct bucket));
+	return 0;
 }
 
-#define DICT_HASH_INIT 2166136261u
-
-static inline u32 hash_data(const byte *data, size_t size)
+int dict_reserve(dict_t *map, int count)
 {
-	size_t nblocks = size / 8;
-	u64 hash       = DICT_HASH_INIT;
-	for (size_t i = 0; i < nblocks; ++i) {
-		hash ^= (u64)data[0] << 0 | (u64)data[1] << 8 | (u64)data[2] << 16 | (u64)data[3] << 24 | (u64)data[4] << 32 |
-			(u64)data[5] << 40 | (u64)data[6] << 48 | (u64)data[7] << 56;
-		hash *= 0xbf58476d1ce4e5b9;
-		data += 8;
+	if (map == NULL || map->buckets == NULL) {
+		return 1;
+	}
+
+	if (count <= DICT_MAX_LOAD * map->capacity) {
+		return 0;
 	}
 
-	u64 last = size & 0xff;
-	switch (size % 8) {
-	case 7: last |= (u64)data[6] << 56; /* falls through */
-	case 6: last |= (u64)data[5] << 48; /* falls through */
-	case 5: last |= (u64)data[4] << 40; /* falls through */
-	case 4: last |= (u64)data[3] << 32; /* falls through */
-	case 3: last |= (u64)data[2] << 24; /* falls through */
-	case 2: last |= (u64)data[1] << 16; /* falls through */
-	case 1:
-		last |= (u64)data[0] << 8;
-		hash ^= last;
-		hash *= 0xd6e8feb86659fd93;
+	int capacity = map->capacity;
+	while (count > DICT_MAX_LOAD * capacity) {
+		capacity *= DICT_RESIZE_FACTOR;
 	}
 
+	return dict_resize(map, capacity);
+}
+
+static u32 hash_key(const dict_t *map, const void *key, size_t ksize)
+{
+	u64 hash = map->hash ? map->hash(key, ksize, map->priv) : hash_bytes(key, ksize, map->seed);
 	return (u32)(hash ^ hash >> 32);
 }
 
+static int key_eq(const dict_t *map, const struct bucket *entry, const void *key, size_t ksize)
+{
+	if (map->eq) {
+		return map->eq(entry->key, entry->ksize, key, ksize, map->priv);
+	}
+
+	return entry->ksize == ksize && mem_eq(entry->key, key, ksize);
+}
+
 static struct bucket *find_entry(const dict_t *map, const void *key, size_t ksize, u32 hash)
 {
 	u32 index = hash % map->capacity;
@@ -103,7 +203,7 @@ static struct bucket *find_entry(const dict_t *map, const void *key, size_t ksiz
 	for (;;) {
 		struct bucket *entry = &map->buckets[index];
 
-		if (entry->key == NULL || (entry->ksize == ksize && entry->hash == hash && mem_cmp(entry->key, key, ksize) == 0)) {
+		if (entry->key == NULL || (entry->hash == hash && key_eq(map, entry, key, ksize))) {
 			return entry;
 		}
 
@@ -111,22 +211,20 @@ static struct bucket *find_entry(const dict_t *map, const void *key, size_t ksiz
 	}
 }
 
-void dict_set(dict_t *map, const void *key, size_t ksize, void *val)
+int dict_set(dict_t *map, const void *key, size_t ksize, void *val)
 {
-	if (map == NULL || key == NULL) {
-		return;
+	if (map == NULL || map->buckets == NULL || key == NULL) {
+		return 1;
 	}
 
-	if (map->count + 1 > DICT_MAX_LOAD * map->capacity) {
-		dict_resize(map);
+	if (map->count + 1 > DICT_MAX_LOAD * map->capacity && dict_resize(map, map->capacity * DICT_RESIZE_FACTOR)) {
+		return 1;
 	}
 
-	u32 hash	     = hash_data(key, ksize);
+	u32 hash	     = hash_key(map, key, ksize);
 	struct bucket *entry = find_entry(map, key, ksize, hash);
 	if (entry->key == NULL) {
-		map->last->next = entry;
-		map->last	= entry;
-		entry->next	= NULL;
+		link_entry(map, entry);
 
 		++map->count;
 
@@ -135,15 +233,17 @@ void dict_set(dict_t *map, const void *key, size_t ksize, void *val)
 		entry->hash  = hash;
 	}
 	entry->value = val;
+
+	return 0;
 }
 
 int dict_get(const dict_t *map, const void *key, size_t ksize, void **out_val)
 {
-	if (map == NULL || key == NULL) {
+	if (map == NULL || map->buckets == NULL || key == NULL) {
 		return 1;
 	}
 
-	u32 hash	     = hash_data(key, ksize);
+	u32 hash	     = hash_key(map, key, ksize);
 	struct bucket *entry = find_entry(map, key, ksize, hash);
 
 	if (out_val != NULL) {
@@ -152,3 +252,80 @@ int dict_get(const dict_t *map, const void *key, size_t ksize, void **out_val)
 
 	return entry->key == NULL;
 }
+
+int dict_remove(dict_t *map, const void *key, size_t ksize, void **out_val)
+{
+	if (map == NULL || map->buckets == NULL || key == NULL) {
+		return 1;
+	}
+
+	struct bucket *entry = find_entry(map, key, ksize, hash_key(map, key, ksize));
+	if (entry->key == NULL) {
+		return 1;
+	}
+
+	if (out_val != NULL) {
+		*out_val = entry->value;
+	}
+
+	unlink_entry(map, entry);
+	--map->count;
+
+	u32 cap	 = map->capacity;
+	u32 hole = (u32)(entry - map->buckets);
+	for (u32 index = (hole + 1) % cap; map->buckets[index].key != NULL; index = (index + 1) % cap) {
+		u32 home = map->buckets[index].hash % cap;
+		if ((index + cap - home) % cap >= (index + cap - hole) % cap) {
+			map->buckets[hole] = map->buckets[index];
+			relink_entry(map, &map->buckets[hole]);
+			hole = index;
+		}
+	}
+
+	map->buckets[hole] = (struct bucket){0};
+
+	return 0;
+}
+
+int dict_probes(const dict_t *map, size_t *total, size_t *max)
+{
+	if (map == NULL || map->buckets == NULL) {
+		return 1;
+	}
+
+	size_t sum = 0;
+	size_t top = 0;
+	u32 cap	   = map->capacity;
+	for (u32 i = 0; i < cap; i++) {
+		if (map->buckets[i].key == NULL) {
+			continue;
+		}
+
+		size_t dist = (i + cap - map->buckets[i].hash % cap) % cap + 1;
+		sum += dist;
+		if (dist > top) {
+			top = dist;
+		}
+	}
+
+	if (total) {
+		*total = sum;
+	}
+
+	if (max) {
+		*max = top;
+	}
+
+	return 0;
+}
+
+size_t dict_print_probes(const dict_t *map, dst_t dst)
+{
+	size_t total, max;
+	if (dict_probes(map, &total, &max)) {
+		return 0;
+	}
+
+	size_t avg = map->count ? total * 100 / map->count : 0;
+	return dputf(dst, "count: %d capacity: %d probes: avg %zu.%02zu max %zu\n", map->count, map->capacity, avg / 100, avg % 100, max);
+}
@@ -0,0 +1,302 @@
+#include "dlist.h"
+
+#include "log.h"
+#include "mem.h"
+
+#define DLIST_FREE ((dlist_node_t)-2)
+
+typedef struct header_s {
+	dlist_node_t prev;
+	dlist_node_t next;
+} header_t;
+
+dlist_t *dlist_init(dlist_t *list, uint cap, size_t size, alloc_t alloc)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	if (arr_init(&list->nodes, cap, sizeof(header_t) + size, alloc) == NULL) {
+		return NULL;
+	}
+
+	list->head = DLIST_END;
+	list->tail = DLIST_END;
+	list->free = DLIST_END;
+	list->cnt  = 0;
+
+	return list;
+}
+
+void dlist_free(dlist_t *list)
+{
+	if (list == NULL) {
+		return;
+	}
+
+	arr_free(&list->nodes);
+	list->head = DLIST_END;
+	list->tail = DLIST_END;
+	list->free = DLIST_END;
+	list->cnt  = 0;
+}
+
+void dlist_reset(dlist_t *list)
+{
+	if (list == NULL) {
+		return;
+	}
+
+	arr_reset(&list->nodes, 0);
+	list->head = DLIST_END;
+	list->tail = DLIST_END;
+	list->free = DLIST_END;
+	list->cnt  = 0;
+}
+
+static header_t *get_header(const dlist_t *list, dlist_node_t node)
+{
+	header_t *header = arr_get(&list->nodes, node);
+	if (header == NULL || header->prev == DLIST_FREE) {
+		return NULL;
+	}
+
+	return header;
+}
+
+static int is_linked(const dlist_t *list, dlist_node_t node, const header_t *header)
+{
+	return header->prev != DLIST_END || list->head == node;
+}
+
+void *dlist_node(dlist_t *list, dlist_node_t *node)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	dlist_node_t id;
+	header_t *header;
+	if (list->free != DLIST_END) {
+		id	   = list->free;
+		header	   = arr_get(&list->nodes, id);
+		list->free = header->next;
+	} else {
+		header = arr_add(&list->nodes, &id);
+		if (header == NULL) {
+			log_error("cutils", "dlist", NULL, "failed to create node");
+			return NULL;
+		}
+	}
+
+	header->prev = DLIST_END;
+	header->next = DLIST_END;
+
+	if (node) {
+		*node = id;
+	}
+
+	return header + 1;
+}
+
+static header_t *get_unlinked(const dlist_t *list, dlist_node_t node)
+{
+	header_t *header = get_header(list, node);
+	if (header == NULL) {
+		log_error("cutils", "dlist", NULL, "invalid node: %d", node);
+		return NULL;
+	}
+
+	if (is_linked(list, node, header)) {
+		log_error("cutils", "dlist", NULL, "node already linked: %d", node);
+		return NULL;
+	}
+
+	return header;
+}
+
+static void link_between(dlist_t *list, dlist_node_t node, header_t *header, dlist_node_t prev, dlist_node_t next)
+{
+	header->prev = prev;
+	header->next = next;
+
+	if (prev == DLIST_END) {
+		list->head = node;
+	} else {
+		((header_t *)arr_get(&list->nodes, prev))->next = node;
+	}
+
+	if (next == DLIST_END) {
+		list->tail = node;
+	} else {
+		((header_t *)arr_get(&list->nodes, next))->prev = node;
+	}
+
+	list->cnt++;
+}
+
+int dlist_app(dlist_t *list, dlist_node_t node)
+{
+	if (list == NULL) {
+		return 1;
+	}
+
+	header_t *header = get_unlinked(list, node);
+	if (header == NULL) {
+		return 1;
+	}
+
+	link_between(list, node, header, list->tail, DLIST_END);
+
+	return 0;
+}
+
+int dlist_prep(dlist_t *list, dlist_node_t node)
+{
+	if (list == NULL) {
+		return 1;
+	}
+
+	header_t *header = get_unlinked(list, node);
+	if (header == NULL) {
+		return 1;
+	}
+
+	link_between(list, node, header, DLIST_END, list->head);
+
+	return 0;
+}
+
+int dlist_ins(dlist_t *list, dlist_node_t prev, dlist_node_t node)
+{
+	if (list == NULL) {
+		return 1;
+	}
+
+	header_t *prev_header = get_header(list, prev);
+	if (prev_header == NULL || !is_linked(list, prev, prev_header)) {
+		log_error("cutils", "dlist", NULL, "invalid node: %d", prev);
+		return 1;
+	}
+
+	header_t *header = get_unlinked(list, node);
+	if (header == NULL) {
+		return 1;
+	}
+
+	link_between(list, node, header, prev, prev_header->next);
+
+	return 0;
+}
+
+int dlist_remove(dlist_t *list, dlist_node_t node)
+{
+	if (list == NULL) {
+		return 1;
+	}
+
+	header_t *header = get_header(list, node);
+	if (header == NULL) {
+		log_error("cutils", "dlist", NULL, "invalid node: %d", node);
+		return 1;
+	}
+
+	if (is_linked(list, node, header)) {
+		if (header->prev == DLIST_END) {
+			list->head = header->next;
+		} else {
+			((header_t *)arr_get(&list->nodes, header->prev))->next = header->next;
+		}
+
+		if (header->next == DLIST_END) {
+			list->tail = header->prev;
+		} else {
+			((header_t *)arr_get(&list->nodes, header->next))->prev = header->prev;
+		}
+
+		list->cnt--;
+	}
+
+	header->prev = DLIST_FREE;
+	header->next = list->free;
+	list->free   = node;
+
+	return 0;
+}
+
+void *dlist_get(const dlist_t *list, dlist_node_t node)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	header_t *header = get_header(list, node);
+	if (header == NULL) {
+		log_error("cutils", "dlist", NULL, "invalid node: %d", node);
+		return NULL;
+	}
+
+	return header + 1;
+}
+
+void *dlist_get_first(const dlist_t *list, dlist_node_t *node)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	if (node) {
+		*node = list->head;
+	}
+
+	return list->head == DLIST_END ? NULL : dlist_get(list, list->head);
+}
+
+void *dlist_get_last(const dlist_t *list, dlist_node_t *node)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	if (node) {
+		*node = list->tail;
+	}
+
+	return list->tail == DLIST_END ? NULL : dlist_get(list, list->tail);
+}
+
+void *dlist_get_next(const dlist_t *list, dlist_node_t node, dlist_node_t *next)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	header_t *header = get_header(list, node);
+	if (header == NULL) {
+		return NULL;
+	}
+
+	if (next) {
+		*next = header->next;
+	}
+
+	return header->next == DLIST_END ? NULL : dlist_get(list, header->next);
+}
+
+void *dlist_get_prev(const dlist_t *list, dlist_node_t node, dlist_node_t *prev)
+{
+	if (list == NULL) {
+		return NULL;
+	}
+
+	header_t *header = get_header(list, node);
+	if (header == NULL) {
+		return NULL;
+	}
+
+	if (prev) {
+		*prev = header->prev;
+	}
+
+	return header->prev == DLIST_END ? NULL : dlist_get(list, header->prev);
+}
@@ -0,0 +1,148 @@
+#include "hash.h"
+
+#include "platform.h"
+#include "sync.h"
+
+#include <string.h>
+#include <time.h>
+
+#if defined(C_WIN)
+	#include <windows.h>
+	#include <bcrypt.h>
+	#if defined(_MSC_VER)
+		#pragma comment(lib, "bcrypt")
+	#endif
+#elif defined(C_LINUX)
+	#include <sys/random.h>
+#else
+	#include <stdlib.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+	#include <intrin.h>
+#endif
+
+#define P0 0xa0761d6478bd642full
+#define P1 0xe7037ed1a0b428dbull
+#define P2 0x8ebc6af09c88c6e3ull
+#define P3 0x589965cc75374cc3ull
+
+static void mum(u64 *a, u64 *b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t)*a * *b;
+	*a	      = (u64)r;
+	*b	      = (u64)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	*a = _umul128(*a, *b, b);
+#else
+	u64 ha = *a >> 32, hb = *b >> 32, la = (u32)*a, lb = (u32)*b;
+	u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	u64 t  = rl + (rm0 << 32);
+	u64 c  = t < rl;
+	u64 lo = t + (rm1 << 32);
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static u64 mix(u64 a, u64 b)
+{
+	mum(&a, &b);
+	return a ^ b;
+}
+
+static u64 r8(const byte *p)
+{
+	u64 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static u64 r4(const byte *p)
+{
+	u32 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+u64 hash_bytes(const void *data, size_t size, u64 seed)
+{
+	const byte *p = data;
+	u64 a, b;
+
+	seed ^= mix(seed ^ P0, P1);
+
+	if (size <= 16) {
+		if (size >= 4) {
+			size_t off = (size >> 3) << 2;
+			a	   = r4(p) << 32 | r4(p + off);
+			b	   = r4(p + size - 4) << 32 | r4(p + size - 4 - off);
+		} else if (size > 0) {
+			a = (u64)p[0] << 16 | (u64)p[size >> 1] << 8 | p[size - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		size_t i = size;
+		if (i > 64) {
+			u64 s1 = seed, s2 = seed, s3 = seed;
+			do {
+				seed = mix(r8(p) ^ P1, r8(p + 8) ^ seed);
+				s1   = mix(r8(p + 16) ^ P2, r8(p + 24) ^ s1);
+				s2   = mix(r8(p + 32) ^ P3, r8(p + 40) ^ s2);
+				s3   = mix(r8(p + 48) ^ P0, r8(p + 56) ^ s3);
+				p += 64;
+				i -= 64;
+			} while (i > 64);
+			seed ^= s1 ^ s2 ^ s3;
+		}
+
+		for (; i > 16; i -= 16, p += 16) {
+			seed = mix(r8(p) ^ P1, r8(p + 8) ^ seed);
+		}
+
+		a = r8(p + i - 16);
+		b = r8(p + i - 8);
+	}
+
+	a ^= P1;
+	b ^= seed;
+	mum(&a, &b);
+
+	return mix(a ^ P0 ^ size, b ^ P1);
+}
+
+static volatile u64 s_seed;
+
+static u64 os_random()
+{
+	u64 val = 0;
+#if defined(C_WIN)
+	if (BCryptGenRandom(NULL, (PUCHAR)&val, sizeof(val), BCRYPT_USE_SYSTEM_PREFERRED_RNG) == 0) {
+		return val;
+	}
+#elif defined(C_LINUX)
+	if (getrandom(&val, sizeof(val), GRND_NONBLOCK) == sizeof(val)) {
+		return val;
+	}
+#else
+	arc4random_buf(&val, sizeof(val));
+	return val;
+#endif
+	return (u64)time(NULL) ^ (u64)(size_t)&s_seed ^ (u64)(size_t)&val;
+}
+
+u64 hash_seed()
+{
+	u64 seed = atom_load64(&s_seed);
+	if (seed != 0) {
+		return seed;
+	}
+
+	atom_cas64(&s_seed, 0, mix(os_random() ^ P2, P3) | 1);
+
+	return atom_load64(&s_seed);
+}
@@ -0,0 +1,403 @@
+#include "hmap.h"
+
+#include "hash.h"
+#include "log.h"
+#include "mem.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define HMAP_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define HMAP_NEON
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#define CTRL_EMPTY   0x80
+#define CTRL_DELETED 0xFE
+
+#define H1(_hash) ((_hash) >> 7)
+#define H2(_hash) ((u8)((_hash) & 0x7f))
+
+static uint group_match(const u8 *ctrl, u8 h2)
+{
+#if defined(HMAP_SSE2)
+	__m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+	return (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+#elif defined(HMAP_NEON)
+	static const u8 bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+	uint8x16_t eq		 = vandq_u8(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2)), vld1q_u8(bits));
+	return (uint)vaddv_u8(vget_low_u8(eq)) | (uint)vaddv_u8(vget_high_u8(eq)) << 8;
+#else
+	uint mask = 0;
+	for (uint i = 0; i < HMAP_GROUP; i++) {
+		mask |= (uint)(ctrl[i] == h2) << i;
+	}
+	return mask;
+#endif
+}
+
+static uint group_empty(const u8 *ctrl)
+{
+	return group_match(ctrl, CTRL_EMPTY);
+}
+
+static uint group_free(const u8 *ctrl)
+{
+#if defined(HMAP_SSE2)
+	return (uint)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#elif defined(HMAP_NEON)
+	static const u8 bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+	uint8x16_t top		 = vandq_u8(vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl)), vdupq_n_s8(0)), vld1q_u8(bits));
+	return (uint)vaddv_u8(vget_low_u8(top)) | (uint)vaddv_u8(vget_high_u8(top)) << 8;
+#else
+	uint mask = 0;
+	for (uint i = 0; i < HMAP_GROUP; i++) {
+		mask |= (uint)(ctrl[i] >> 7) << i;
+	}
+	return mask;
+#endif
+}
+
+static uint first_bit(uint mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (uint)index;
+#else
+	return (uint)__builtin_ctz(mask);
+#endif
+}
+
+static u64 hash_key(const hmap_t *map, const void *key, size_t ksize)
+{
+	return map->hash ? map->hash(key, ksize, map->priv) : hash_bytes(key, ksize, map->seed);
+}
+
+static u64 r8(const byte *p)
+{
+	u64 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static u32 r4(const byte *p)
+{
+	u32 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// inline keys are compared with two overlapping loads instead of a mem_eq() call
+static int slot_eq(const hmap_t *map, const hmap_slot_t *slot, const void *key, size_t ksize)
+{
+	if (map->eq) {
+		return map->eq(hmap_key(slot), slot->ksize, key, ksize, map->priv);
+	}
+
+	if (slot->ksize != ksize) {
+		return 0;
+	}
+
+	if (ksize > HMAP_INLINE) {
+		return mem_eq(slot->key.ptr, key, ksize);
+	}
+
+	const byte *a = slot->key.data;
+	const byte *b = key;
+
+	if (ksize >= 8) {
+		return ((r8(a) ^ r8(b)) | (r8(a + ksize - 8) ^ r8(b + ksize - 8))) == 0;
+	}
+
+	if (ksize >= 4) {
+		return ((r4(a) ^ r4(b)) | (r4(a + ksize - 4) ^ r4(b + ksize - 4))) == 0;
+	}
+
+	for (size_t i = 0; i < ksize; i++) {
+		if (a[i] != b[i]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static size_t table_size(uint cap)
+{
+	return cap + (size_t)cap * sizeof(hmap_slot_t);
+}
+
+static uint table_left(uint cap)
+{
+	return cap - cap / 8;
+}
+
+static int table_init(hmap_t *map, uint cap)
+{
+	u8 *table = alloc_alloc(&map->alloc, table_size(cap));
+	if (table == NULL) {
+		log_error("cutils", "hmap", NULL, "failed to allocate table");
+		return 1;
+	}
+
+	mem_set(table, CTRL_EMPTY, cap);
+
+	map->ctrl  = table;
+	map->slots = (hmap_slot_t *)(table + cap);
+	map->cap   = cap;
+	map->left  = table_left(cap);
+
+	return 0;
+}
+
+static uint find_free(const hmap_t *map, u64 hash)
+{
+	uint mask  = map->cap / HMAP_GROUP - 1;
+	uint group = (uint)H1(hash) & mask;
+
+	for (uint step = 1;; step++) {
+		uint free = group_free(map->ctrl + group * HMAP_GROUP);
+		if (free) {
+			return group * HMAP_GROUP + first_bit(free);
+		}
+
+		group = (group + step) & mask;
+	}
+}
+
+static uint find_slot(const hmap_t *map, const void *key, size_t ksize, u64 hash)
+{
+	uint mask  = map->cap / HMAP_GROUP - 1;
+	uint group = (uint)H1(hash) & mask;
+
+	for (uint step = 1; step <= mask + 1; step++) {
+		const u8 *ctrl = map->ctrl + group * HMAP_GROUP;
+
+		for (uint match = group_match(ctrl, H2(hash)); match; match &= match - 1) {
+			uint i = group * HMAP_GROUP + first_bit(match);
+			if (slot_eq(map, &map->slots[i], key, ksize)) {
+				return i;
+			}
+		}
+
+		if (group_empty(ctrl)) {
+			break;
+		}
+
+		group = (group + step) & mask;
+	}
+
+	return (uint)-1;
+}
+
+static int rehash(hmap_t *map)
+{
+	hmap_t old = *map;
+
+	uint cap = map->cnt * 2 >= table_left(map->cap) ? map->cap * 2 : map->cap;
+	if (table_init(map, cap)) {
+		*map = old;
+		return 1;
+	}
+
+	for (uint i = 0; i < old.cap; i++) {
+		if (old.ctrl[i] & CTRL_EMPTY) {
+			continue;
+		}
+
+		u64 hash = hash_key(map, hmap_key(&old.slots[i]), old.slots[i].ksize);
+		uint j	 = find_free(map, hash);
+
+		map->ctrl[j]  = H2(hash);
+		map->slots[j] = old.slots[i];
+		map->left--;
+	}
+
+	alloc_free(&map->alloc, old.ctrl, table_size(old.cap));
+
+	return 0;
+}
+
+hmap_t *hmap_init(hmap_t *map, uint cap, alloc_t alloc)
+{
+	if (map == NULL) {
+		return NULL;
+	}
+
+	uint size = HMAP_GROUP;
+	while (table_left(size) < cap) {
+		size *= 2;
+	}
+
+	map->cnt   = 0;
+	map->seed  = hash_seed();
+	map->hash  = NULL;
+	map->eq	   = NULL;
+	map->priv  = NULL;
+	map->alloc = alloc;
+
+	if (table_init(map, size)) {
+		return NULL;
+	}
+
+	return map;
+}
+
+int hmap_set_hash(hmap_t *map, hash_cb hash, hash_eq_cb eq, const void *priv)
+{
+	if (map == NULL) {
+		return 1;
+	}
+
+	if (map->cnt > 0) {
+		log_error("cutils", "hmap", NULL, "hash can only be changed on an empty map");
+		return 1;
+	}
+
+	map->hash = hash;
+	map->eq	  = eq;
+	map->priv = priv;
+
+	return 0;
+}
+
+void hmap_free(hmap_t *map)
+{
+	if (map == NULL || map->ctrl == NULL) {
+		return;
+	}
+
+	alloc_free(&map->alloc, map->ctrl, table_size(map->cap));
+	map->ctrl  = NULL;
+	map->slots = NULL;
+	map->cap   = 0;
+	map->cnt   = 0;
+	map->left  = 0;
+}
+
+void hmap_reset(hmap_t *map)
+{
+	if (map == NULL || map->ctrl == NULL) {
+		return;
+	}
+
+	mem_set(map->ctrl, CTRL_EMPTY, map->cap);
+	map->cnt  = 0;
+	map->left = table_left(map->cap);
+}
+
+int hmap_set(hmap_t *map, const void *key, size_t ksize, void *value)
+{
+	if (map == NULL || map->ctrl == NULL || key == NULL) {
+		return 1;
+	}
+
+	u64 hash = hash_key(map, key, ksize);
+	uint i	 = find_slot(map, key, ksize, hash);
+	if (i != (uint)-1) {
+		map->slots[i].value = value;
+		return 0;
+	}
+
+	i = find_free(map, hash);
+	if (map->ctrl[i] == CTRL_EMPTY && map->left == 0) {
+		if (rehash(map)) {
+			return 1;
+		}
+		i = find_free(map, hash);
+	}
+
+	if (map->ctrl[i] == CTRL_EMPTY) {
+		map->left--;
+	}
+
+	hmap_slot_t *slot = &map->slots[i];
+	if (ksize <= HMAP_INLINE) {
+		mem_copy(slot->key.data, sizeof(slot->key.data), key, ksize);
+	} else {
+		slot->key.ptr = key;
+	}
+	slot->ksize = ksize;
+	slot->value = value;
+
+	map->ctrl[i] = H2(hash);
+	map->cnt++;
+
+	return 0;
+}
+
+int hmap_get(const hmap_t *map, const void *key, size_t ksize, void **value)
+{
+	if (map == NULL || map->ctrl == NULL || key == NULL) {
+		return 1;
+	}
+
+	uint i = find_slot(map, key, ksize, hash_key(map, key, ksize));
+	if (i == (uint)-1) {
+		return 1;
+	}
+
+	if (value) {
+		*value = map->slots[i].value;
+	}
+
+	return 0;
+}
+
+int hmap_remove(hmap_t *map, const void *key, size_t ksize, void **value)
+{
+	if (map == NULL || map->ctrl == NULL || key == NULL) {
+		return 1;
+	}
+
+	uint i = find_slot(map, key, ksize, hash_key(map, key, ksize));
+	if (i == (uint)-1) {
+		return 1;
+	}
+
+	if (value) {
+		*value = map->slots[i].value;
+	}
+
+	if (group_empty(map->ctrl + i / HMAP_GROUP * HMAP_GROUP)) {
+		map->ctrl[i] = CTRL_EMPTY;
+		map->left++;
+	} else {
+		map->ctrl[i] = CTRL_DELETED;
+	}
+
+	map->cnt--;
+
+	return 0;
+}
+
+const void *hmap_key(const hmap_slot_t *slot)
+{
+	if (slot == NULL) {
+		return NULL;
+	}
+
+	return slot->ksize <= HMAP_INLINE ? slot->key.data : slot->key.ptr;
+}
+
+hmap_slot_t *hmap_next(const hmap_t *map, uint *i)
+{
+	if (map == NULL || i == NULL) {
+		return NULL;
+	}
+
+	for (; *i < map->cap; (*i)++) {
+		if ((map->ctrl[*i] & CTRL_EMPTY) == 0) {
+			return &map->slots[*i];
+		}
+	}
+
+	return NULL;
+}
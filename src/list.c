@@ -3,18 +3,63 @@
 #include "log.h"
 #include "mem.h"
 
+// released nodes store their free list link with the high bit set, so live ids must stay below NODE_FREE_END
+#define NODE_FREE     ((list_node_t)1 << (sizeof(list_node_t) * 8 - 1))
+#define NODE_FREE_END (NODE_FREE - 2)
+
 typedef struct header_s {
 	list_node_t next;
 } header_t;
 
+static int is_free(const header_t *header)
+{
+	return header->next != (list_node_t)-1 && (header->next & NODE_FREE);
+}
+
+static void push_free(list_t *list, list_node_t node, header_t *header)
+{
+	header->next = NODE_FREE | (list->free == (list_node_t)-1 ? NODE_FREE_END : list->free);
+	list->free   = node;
+	list->freed++;
+}
+
+static header_t *pop_free(list_t *list, list_node_t *node)
+{
+	*node		 = list->free;
+	header_t *header = arr_get(&list->nodes, *node);
+
+	list_node_t next = header->next & ~NODE_FREE;
+	list->free	 = next == NODE_FREE_END ? (list_node_t)-1 : next;
+	list->freed--;
+
+	return header;
+}
+
 list_t *list_init(list_t *list, uint cap, size_t size, alloc_t alloc)
 {
-	return arr_init(list, cap, sizeof(header_t) + size, alloc);
+	if (list == NULL) {
+		return NULL;
+	}
+
+	if (arr_init(&list->nodes, cap, sizeof(header_t) + size, alloc) == NULL) {
+		return NULL;
+	}
+
+	list->free  = (list_node_t)-1;
+	list->freed = 0;
+
+	return list;
 }
 
 void list_free(list_t *list)
 {
-	arr_free(list);
+	if (list == NULL) {
+		return;
+	}
+
+	arr_free(&list->nodes);
+	list->free  = (list_node_t)-1;
+	list->freed = 0;
 }
 
 void list_reset(list_t *list, uint cnt)
@@ -23,17 +68,21 @@ void list_reset(list_t *list, uint cnt)
 		return;
 	}
 
-	if (cnt > list->cnt) {
-		cnt = list->cnt;
+	if (cnt > list->nodes.cnt) {
+		cnt = list->nodes.cnt;
 	}
 
-	list->cnt = cnt;
+	list->nodes.cnt = cnt;
+	list->free	= (list_node_t)-1;
+	list->freed	= 0;
 
 	header_t *val;
 	uint i = 0;
-	arr_foreach(list, i, val)
+	arr_foreach(&list->nodes, i, val)
 	{
-		if (val->next >= cnt) {
+		if (is_free(val)) {
+			push_free(list, i, val);
+		} else if (val->next >= cnt) {
 			val->next = (list_node_t)-1;
 		}
 	}
@@ -45,10 +94,24 @@ void *list_node(list_t *list, list_node_t *node)
 		return NULL;
 	}
 
-	header_t *header = arr_add(list, node);
-	if (header == NULL) {
-		log_error("cutils", "list", NULL, "failed to create node");
-		return NULL;
+	header_t *header;
+	if (list->free != (list_node_t)-1) {
+		list_node_t id;
+		header = pop_free(list, &id);
+		if (node) {
+			*node = id;
+		}
+	} else {
+		if (list->nodes.cnt >= NODE_FREE_END) {
+			log_error("cutils", "list", NULL, "failed to create node: too many nodes");
+			return NULL;
+		}
+
+		header = arr_add(&list->nodes, node);
+		if (header == NULL) {
+			log_error("cutils", "list", NULL, "failed to create node");
+			return NULL;
+		}
 	}
 
 	header->next = (list_node_t)-1;
@@ -73,14 +136,14 @@ int list_app(list_t *list, list_node_t node, list_node_t next)
 	}
 
 	list_node_t *target = &node;
-	while (*target < list->cnt) {
+	while (*target < list->nodes.cnt) {
 
 		if (*target == next) {
 			log_error("cutils", "list", NULL, "append will create a loop: %d", next);
 			return 1;
 		}
 
-		target = &((header_t *)arr_get(list, *target))->next;
+		target = &((header_t *)arr_get(&list->nodes, *target))->next;
 		if (*target == node) {
 			log_error("cutils", "list", NULL, "loop detected at: %d", *target);
 			return 1;
@@ -92,19 +155,130 @@ int list_app(list_t *list, list_node_t node, list_node_t next)
 	return 0;
 }
 
+static list_node_t *get_tail(list_t *list, list_node_t node)
+{
+	list_node_t *target = &node;
+	while (*target < list->nodes.cnt) {
+		target = &((header_t *)arr_get(&list->nodes, *target))->next;
+	}
+
+	return target;
+}
+
+// list_app_n() marks visited nodes by setting the free bit on their link, live ids never reach NODE_FREE_END
+#define NODE_MARK_END (NODE_FREE | NODE_FREE_END)
+
+static int is_marked(const header_t *header)
+{
+	return is_free(header);
+}
+
+static int mark_chain(list_t *list, list_node_t node)
+{
+	while (node < list->nodes.cnt) {
+		header_t *header = arr_get(&list->nodes, node);
+		if (is_marked(header)) {
+			return 1;
+		}
+
+		node	     = header->next;
+		header->next = node == (list_node_t)-1 ? NODE_MARK_END : node | NODE_FREE;
+	}
+
+	return 0;
+}
+
+static void unmark_chain(list_t *list, list_node_t node)
+{
+	while (node < list->nodes.cnt) {
+		header_t *header = arr_get(&list->nodes, node);
+		if (!is_marked(header)) {
+			return;
+		}
+
+		header->next = header->next == NODE_MARK_END ? (list_node_t)-1 : header->next & ~NODE_FREE;
+		node	     = header->next;
+	}
+}
+
+int list_app_n(list_t *list, list_node_t node, const list_node_t *nodes, uint cnt)
+{
+	if (list == NULL || nodes == NULL) {
+		return 1;
+	}
+
+	if (list_get(list, node) == NULL) {
+		log_error("cutils", "list", NULL, "failed to get node");
+		return 1;
+	}
+
+	for (uint i = 0; i < cnt; i++) {
+		if (list_get(list, nodes[i]) == NULL) {
+			log_error("cutils", "list", NULL, "failed to get next node");
+			return 1;
+		}
+	}
+
+	uint marked = 0;
+	int loop    = mark_chain(list, node);
+	while (!loop && marked < cnt) {
+		loop = mark_chain(list, nodes[marked++]);
+	}
+
+	unmark_chain(list, node);
+	for (uint i = 0; i < marked; i++) {
+		unmark_chain(list, nodes[i]);
+	}
+
+	if (loop) {
+		log_error("cutils", "list", NULL, "append will create a loop: %d", marked ? nodes[marked - 1] : node);
+		return 1;
+	}
+
+	list_node_t *target = get_tail(list, node);
+	for (uint i = 0; i < cnt; i++) {
+		*target = nodes[i];
+		target	= get_tail(list, nodes[i]);
+	}
+
+	return 0;
+}
+
+int list_set_next(list_t *list, list_node_t node, list_node_t next)
+{
+	if (list == NULL) {
+		return 1;
+	}
+
+	header_t *header = arr_get(&list->nodes, node);
+	if (header == NULL || is_free(header)) {
+		log_error("cutils", "list", NULL, "failed to get node");
+		return 1;
+	}
+
+	if (next != (list_node_t)-1 && list_get(list, next) == NULL) {
+		log_error("cutils", "list", NULL, "failed to get next node");
+		return 1;
+	}
+
+	header->next = next;
+
+	return 0;
+}
+
 int list_remove(list_t *list, list_node_t node)
 {
 	if (list == NULL) {
 		return 1;
 	}
 
-	header_t *header = arr_get(list, node);
-	if (header == NULL) {
+	header_t *header = arr_get(&list->nodes, node);
+	if (header == NULL || is_free(header)) {
 		return 1;
 	}
 
-	for (uint i = 0; i < list->cnt; i++) {
-		header_t *prev = arr_get(list, i);
+	for (uint i = 0; i < list->nodes.cnt; i++) {
+		header_t *prev = arr_get(&list->nodes, i);
 		if (i != node && prev->next == node) {
 			prev->next = header->next;
 		}
@@ -113,14 +287,170 @@ int list_remove(list_t *list, list_node_t node)
 	return 0;
 }
 
+int list_release(list_t *list, list_node_t node)
+{
+	if (list == NULL) {
+		return 1;
+	}
+
+	header_t *header = arr_get(&list->nodes, node);
+	if (header == NULL) {
+		return 1;
+	}
+
+	if (is_free(header)) {
+		log_error("cutils", "list", NULL, "node already released: %d", node);
+		return 1;
+	}
+
+	push_free(list, node, header);
+
+	return 0;
+}
+
+int list_delete(list_t *list, list_node_t node)
+{
+	if (list_remove(list, node)) {
+		return 1;
+	}
+
+	return list_release(list, node);
+}
+
+int list_compact(list_t *list, list_node_t *remap)
+{
+	if (list == NULL) {
+		return 1;
+	}
+
+	uint cnt = list->nodes.cnt;
+	if (cnt == 0) {
+		return 0;
+	}
+
+	list_node_t *ids = remap;
+	if (ids == NULL) {
+		ids = alloc_alloc(&list->nodes.alloc, cnt * sizeof(list_node_t));
+		if (ids == NULL) {
+			log_error("cutils", "list", NULL, "failed to allocate remap table");
+			return 1;
+		}
+	}
+
+	uint used = 0;
+	for (uint i = 0; i < cnt; i++) {
+		header_t *header = arr_get(&list->nodes, i);
+		if (is_free(header)) {
+			ids[i] = (list_node_t)-1;
+			continue;
+		}
+
+		if (used != i) {
+			mem_copy(arr_get(&list->nodes, used), list->nodes.size, header, list->nodes.size);
+		}
+
+		ids[i] = used++;
+	}
+
+	list->nodes.cnt = used;
+	list->free	= (list_node_t)-1;
+	list->freed	= 0;
+
+	header_t *header;
+	uint i = 0;
+	arr_foreach(&list->nodes, i, header)
+	{
+		if (header->next < cnt) {
+			header->next = ids[header->next];
+		}
+	}
+
+	if (remap == NULL) {
+		alloc_free(&list->nodes.alloc, ids, cnt * sizeof(list_node_t));
+	}
+
+	return 0;
+}
+
+int list_remap(list_t *list, const list_node_t *remap)
+{
+	if (list == NULL || remap == NULL) {
+		return 1;
+	}
+
+	uint cnt    = list->nodes.cnt;
+	size_t size = list->nodes.size;
+	if (cnt == 0) {
+		return 0;
+	}
+
+	byte *data = alloc_alloc(&list->nodes.alloc, cnt * size + cnt);
+	if (data == NULL) {
+		log_error("cutils", "list", NULL, "failed to allocate remap buffer");
+		return 1;
+	}
+
+	byte *seen = data + cnt * size;
+	mem_set(seen, 0, cnt);
+
+	uint used	 = 0;
+	list_node_t last = 0;
+	for (uint i = 0; i < cnt; i++) {
+		if (remap[i] == (list_node_t)-1) {
+			continue;
+		}
+
+		if (remap[i] >= cnt || seen[remap[i]]) {
+			log_error("cutils", "list", NULL, "invalid remap target: %d -> %d", i, remap[i]);
+			alloc_free(&list->nodes.alloc, data, cnt * size + cnt);
+			return 1;
+		}
+
+		seen[remap[i]] = 1;
+		last	       = remap[i] > last ? remap[i] : last;
+		used++;
+	}
+
+	if (used > 0 && last >= used) {
+		log_error("cutils", "list", NULL, "remap targets are not contiguous: %d >= %d", last, used);
+		alloc_free(&list->nodes.alloc, data, cnt * size + cnt);
+		return 1;
+	}
+
+	mem_copy(data, cnt * size, list->nodes.data, cnt * size);
+
+	for (uint i = 0; i < cnt; i++) {
+		if (remap[i] < cnt) {
+			mem_copy(arr_get(&list->nodes, remap[i]), size, data + i * size, size);
+		}
+	}
+
+	list->nodes.cnt = used;
+	list->free	= (list_node_t)-1;
+	list->freed	= 0;
+
+	header_t *header;
+	uint i = 0;
+	arr_foreach(&list->nodes, i, header)
+	{
+		if (header->next < cnt) {
+			header->next = remap[header->next];
+		}
+	}
+
+	alloc_free(&list->nodes.alloc, data, cnt * size + cnt);
+
+	return 0;
+}
+
 void *list_get(const list_t *list, list_node_t node)
 {
 	if (list == NULL) {
 		return NULL;
 	}
 
-	header_t *header = arr_get(list, node);
-	if (header == NULL) {
+	header_t *header = arr_get(&list->nodes, node);
+	if (header == NULL || is_free(header)) {
 		log_error("cutils", "list", NULL, "failed to get node");
 		return NULL;
 	}
@@ -130,8 +460,12 @@ void *list_get(const list_t *list, list_node_t node)
 
 void *list_get_next(const list_t *list, list_node_t node, list_node_t *next)
 {
-	header_t *header = arr_get(list, node);
-	if (header == NULL) {
+	if (list == NULL) {
+		return NULL;
+	}
+
+	header_t *header = arr_get(&list->nodes, node);
+	if (header == NULL || is_free(header)) {
 		return NULL;
 	}
 
@@ -158,10 +492,10 @@ void *list_get_at(const list_t *list, list_node_t start, uint index, list_node_t
 	}
 
 	list_node_t cur	 = start;
-	header_t *header = arr_get(list, cur);
-	for (uint i = 0; i < index && header && cur < list->cnt; i++) {
+	header_t *header = arr_get(&list->nodes, cur);
+	for (uint i = 0; i < index && header && cur < list->nodes.cnt; i++) {
 		cur    = header->next;
-		header = arr_get(list, cur);
+		header = arr_get(&list->nodes, cur);
 	}
 
 	if (node) {
@@ -171,6 +505,22 @@ void *list_get_at(const list_t *list, list_node_t start, uint index, list_node_t
 	return header == NULL ? NULL : header + 1;
 }
 
+void *list_get_used(const list_t *list, list_node_t *node)
+{
+	if (list == NULL || node == NULL) {
+		return NULL;
+	}
+
+	for (; *node < list->nodes.cnt; (*node)++) {
+		header_t *header = arr_get(&list->nodes, *node);
+		if (!is_free(header)) {
+			return header + 1;
+		}
+	}
+
+	return NULL;
+}
+
 size_t list_print(const list_t *list, list_node_t node, list_print_cb cb, dst_t dst, const void *priv)
 {
 	if (list == NULL || cb == NULL) {
@@ -197,8 +547,12 @@ size_t list_dbg(const list_t *list, dst_t dst)
 
 	list_node_t i = 0;
 	header_t *header;
-	arr_foreach(list, i, header)
+	arr_foreach(&list->nodes, i, header)
 	{
+		if (is_free(header)) {
+			continue;
+		}
+
 		if (list_get_next(list, i, NULL) == 0) {
 			dst.off += dputf(dst, "%zu -> (end)\n", i);
 		} else {
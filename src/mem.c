@@ -2,11 +2,96 @@
 
 #include "log.h"
 #include "platform.h"
+#include "sync.h"
 
 #include <memory.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define MEM_SSE2
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define MEM_AVX2
+#endif
+
+#define TCACHE_MIN_SIZE	 16
+#define TCACHE_CLASSES	 6
+#define TCACHE_MAG_SIZE	 32
+#define TCACHE_POOL_SIZE 1024
+
+#define TCACHE_SIZE(_cls) ((size_t)TCACHE_MIN_SIZE << (_cls))
+#define TCACHE_MAX_SIZE	  TCACHE_SIZE(TCACHE_CLASSES - 1)
+
+#define MEM_SHARDS 16
+#define MEM_TAGS   32
+#define MEM_HDR	   16
+
+typedef struct tcache_mag_s {
+	void *ptrs[TCACHE_MAG_SIZE];
+	int cnt;
+} tcache_mag_t;
+
+typedef struct tcache_s {
+	tcache_mag_t mags[TCACHE_CLASSES];
+} tcache_t;
+
+typedef struct tcache_pool_s {
+	void *free;
+	int cnt;
+} tcache_pool_t;
+
+// Prepended to every block while tag tracking is on, sized to keep malloc alignment
+typedef union mem_hdr_u {
+	struct {
+		u32 tag;
+		u32 gen;
+	};
+	byte pad[MEM_HDR];
+} mem_hdr_t;
+
+typedef struct tag_stats_s {
+	volatile size_t bytes;
+	volatile size_t live;
+	volatile size_t allocs;
+	volatile size_t reallocs;
+} tag_stats_t;
+
+typedef struct shard_s {
+	volatile size_t added;
+	volatile size_t freed;
+	volatile size_t total;
+	volatile size_t allocs;
+	volatile size_t reallocs;
+	tag_stats_t tags[MEM_TAGS];
+	volatile size_t tags_lost;
+	byte pad[64];
+} shard_t;
+
 static int s_oom;
+static int s_tcache;
+static volatile size_t s_shards;
+static int s_tags;
+
+static lock_t s_lock;
+static tcache_pool_t s_pool[TCACHE_CLASSES];
+static SYNC_TLS tcache_t s_tc;
+
+static shard_t s_shard[MEM_SHARDS];
+static volatile size_t s_shard_next;
+static SYNC_TLS shard_t *s_shard_cur;
+
+static const char *volatile s_tag_names[MEM_TAGS];
+static mem_tag_stats_t s_tag_sum[MEM_TAGS];
+static size_t s_tag_lost;
+static volatile size_t s_tag_gen = 1;
+
+static SYNC_TLS const char *s_tag;
+static SYNC_TLS int s_tag_idx;
+static SYNC_TLS size_t s_tag_idx_gen;
 
 static void get_max_unit(size_t *size, char *u)
 {
@@ -40,8 +125,239 @@ static size_t print_mem(size_t mem, dst_t dst)
 	return dst.off - off;
 }
 
+static shard_t *get_shard()
+{
+	if (s_shard_cur == NULL) {
+		s_shard_cur = &s_shard[(atom_add(&s_shard_next, 1) - 1) % MEM_SHARDS];
+	}
+
+	return s_shard_cur;
+}
+
+static int tag_index(const char *tag)
+{
+	for (int i = 0; i < MEM_TAGS; i++) {
+		if (s_tag_names[i] == NULL) {
+			atom_cas_ptr((void *volatile *)&s_tag_names[i], NULL, (void *)tag);
+		}
+
+		if (s_tag_names[i] == tag) {
+			return i;
+		}
+	}
+
+	return MEM_TAGS;
+}
+
+static u32 get_tag()
+{
+	if (s_tag == NULL) {
+		return 0;
+	}
+
+	size_t gen = atom_load(&s_tag_gen);
+	if (s_tag_idx_gen != gen) {
+		s_tag_idx     = tag_index(s_tag);
+		s_tag_idx_gen = gen;
+	}
+
+	if (s_tag_idx == MEM_TAGS) {
+		if (!s_tcache && !s_shards) {
+			s_tag_lost++;
+		} else {
+			atom_add(&get_shard()->tags_lost, 1);
+		}
+		return 0;
+	}
+
+	return (u32)s_tag_idx + 1;
+}
+
+static void tag_stats(const mem_hdr_t *hdr, size_t old_size, size_t new_size, int is_realloc)
+{
+	if (hdr->tag == 0 || hdr->gen != (u32)atom_load(&s_tag_gen)) {
+		return;
+	}
+
+	size_t bytes	= new_size > old_size ? new_size - old_size : 0;
+	size_t allocs	= !is_realloc && new_size > 0 ? 1 : 0;
+	size_t reallocs = is_realloc ? 1 : 0;
+
+	if (!s_tcache && !s_shards) {
+		mem_tag_stats_t *sum = &s_tag_sum[hdr->tag - 1];
+		sum->bytes += bytes;
+		sum->live += new_size - old_size;
+		sum->allocs += allocs;
+		sum->reallocs += reallocs;
+		if (sum->live > sum->peak) {
+			sum->peak = sum->live;
+		}
+		return;
+	}
+
+	tag_stats_t *stats = &get_shard()->tags[hdr->tag - 1];
+	atom_add(&stats->bytes, bytes);
+	atom_add(&stats->live, new_size - old_size);
+	atom_add(&stats->allocs, allocs);
+	atom_add(&stats->reallocs, reallocs);
+}
+
+static void *hdr_set(void *raw, size_t size)
+{
+	if (raw == NULL || !s_tags) {
+		return raw;
+	}
+
+	mem_hdr_t *hdr = raw;
+	hdr->tag       = get_tag();
+	hdr->gen       = (u32)atom_load(&s_tag_gen);
+	tag_stats(hdr, 0, size, 0);
+
+	return (byte *)raw + MEM_HDR;
+}
+
+static void stats_alloc(size_t size)
+{
+	if (!s_tcache && !s_shards) {
+		mem_stats_alloc(size);
+		return;
+	}
+
+	shard_t *shard = get_shard();
+	atom_add(&shard->added, size);
+	atom_add(&shard->total, size);
+	atom_add(&shard->allocs, 1);
+}
+
+static void stats_realloc(size_t old_size, size_t new_size)
+{
+	if (!s_tcache && !s_shards) {
+		mem_stats_realloc(old_size, new_size);
+		return;
+	}
+
+	shard_t *shard = get_shard();
+	atom_add(&shard->added, new_size);
+	atom_add(&shard->freed, old_size);
+	if (new_size > old_size) {
+		atom_add(&shard->total, new_size - old_size);
+	}
+	atom_add(&shard->reallocs, 1);
+}
+
+static void stats_free(size_t size)
+{
+	if (!s_tcache && !s_shards) {
+		mem_stats_free(size);
+		return;
+	}
+
+	atom_add(&get_shard()->freed, size);
+}
+
+static int tcache_class(size_t size)
+{
+	int cls = 0;
+	while (cls < TCACHE_CLASSES && TCACHE_SIZE(cls) < size) {
+		cls++;
+	}
+
+	return cls;
+}
+
+static void *tcache_alloc(size_t size)
+{
+	int cls = tcache_class(size);
+	if (cls >= TCACHE_CLASSES) {
+		return malloc(size);
+	}
+
+	tcache_mag_t *mag = &s_tc.mags[cls];
+	if (mag->cnt == 0) {
+		tcache_pool_t *pool = &s_pool[cls];
+
+		lock_acquire(&s_lock);
+		while (pool->free && mag->cnt < TCACHE_MAG_SIZE / 2) {
+			void *ptr	      = pool->free;
+			pool->free	      = *(void **)ptr;
+			mag->ptrs[mag->cnt++] = ptr;
+			pool->cnt--;
+		}
+		lock_release(&s_lock);
+
+		if (mag->cnt == 0) {
+			return malloc(TCACHE_SIZE(cls));
+		}
+	}
+
+	return mag->ptrs[--mag->cnt];
+}
+
+static void *tcache_calloc(size_t count, size_t size)
+{
+	if (size > 0 && count > TCACHE_MAX_SIZE / size) {
+		return calloc(count, size);
+	}
+
+	void *ptr = tcache_alloc(count * size);
+	if (ptr == NULL) {
+		return NULL;
+	}
+
+	return memset(ptr, 0, count * size);
+}
+
+static void *tcache_realloc(void *memory, size_t new_size, size_t old_size)
+{
+	int old_cls = tcache_class(old_size);
+	int new_cls = tcache_class(new_size);
+
+	if (new_cls < TCACHE_CLASSES && new_cls == old_cls) {
+		return memory;
+	}
+
+	return realloc(memory, new_cls < TCACHE_CLASSES ? TCACHE_SIZE(new_cls) : new_size);
+}
+
+static void tcache_drain(int cls, int cnt)
+{
+	tcache_mag_t *mag   = &s_tc.mags[cls];
+	tcache_pool_t *pool = &s_pool[cls];
+
+	lock_acquire(&s_lock);
+	while (mag->cnt > 0 && cnt-- > 0) {
+		void *ptr = mag->ptrs[--mag->cnt];
+		if (pool->cnt < TCACHE_POOL_SIZE) {
+			*(void **)ptr = pool->free;
+			pool->free    = ptr;
+			pool->cnt++;
+		} else {
+			free(ptr);
+		}
+	}
+	lock_release(&s_lock);
+}
+
+static void tcache_free(void *memory, size_t size)
+{
+	int cls = tcache_class(size);
+	if (cls >= TCACHE_CLASSES) {
+		free(memory);
+		return;
+	}
+
+	tcache_mag_t *mag = &s_tc.mags[cls];
+	if (mag->cnt == TCACHE_MAG_SIZE) {
+		tcache_drain(cls, TCACHE_MAG_SIZE / 2);
+	}
+
+	mag->ptrs[mag->cnt++] = memory;
+}
+
 size_t mem_print(dst_t dst)
 {
+	mem_merge();
+
 	const mem_stats_t *stats = mem_stats_get();
 	if (stats == NULL) {
 		return 0;
@@ -64,6 +380,8 @@ size_t mem_print(dst_t dst)
 
 int mem_check()
 {
+	mem_merge();
+
 	const mem_stats_t *stats = mem_stats_get();
 	if (stats->mem == 0) {
 		return 0;
@@ -81,14 +399,17 @@ void *mem_alloc(size_t size)
 		log_warn("cutils", "mem", NULL, "malloc 0 bytes");
 	}
 
-	void *ptr = size > 0 && s_oom ? NULL : malloc(size);
+	size_t raw = s_tags ? size + MEM_HDR : size;
+
+	void *ptr = size > 0 && s_oom ? NULL : s_tcache ? tcache_alloc(raw) : malloc(raw);
+	ptr	  = hdr_set(ptr, size);
 
 	if (ptr == NULL) {
 		log_error("cutils", "mem", NULL, "out of memory");
 		return NULL;
 	}
 
-	mem_stats_alloc(size);
+	stats_alloc(size);
 
 	return ptr;
 }
@@ -99,14 +420,22 @@ void *mem_calloc(size_t count, size_t size)
 		log_warn("cutils", "mem", NULL, "calloc 0 bytes");
 	}
 
-	void *ptr = count * size > 0 && s_oom ? NULL : calloc(count, size);
+	void *ptr;
+	if (s_tags) {
+		size_t raw = size > 0 && count > (SIZE_MAX - MEM_HDR) / size ? SIZE_MAX : count * size + MEM_HDR;
+
+		ptr = count * size > 0 && s_oom ? NULL : s_tcache ? tcache_calloc(1, raw) : calloc(1, raw);
+		ptr = hdr_set(ptr, count * size);
+	} else {
+		ptr = count * size > 0 && s_oom ? NULL : s_tcache ? tcache_calloc(count, size) : calloc(count, size);
+	}
 
 	if (ptr == NULL) {
 		log_error("cutils", "mem", NULL, "out of memory");
 		return NULL;
 	}
 
-	mem_stats_alloc(count * size);
+	stats_alloc(count * size);
 
 	return ptr;
 }
@@ -132,14 +461,25 @@ void *mem_realloc(void *memory, size_t new_size, size_t old_size)
 		return mem_alloc(new_size);
 	}
 
-	void *ptr = new_size > old_size && s_oom ? NULL : realloc(memory, new_size);
+	size_t hdr = s_tags ? MEM_HDR : 0;
+	void *raw  = (byte *)memory - hdr;
+
+	void *ptr = NULL;
+	if (new_size <= old_size || !s_oom) {
+		ptr = s_tcache ? tcache_realloc(raw, new_size + hdr, old_size + hdr) : realloc(raw, new_size + hdr);
+	}
 
 	if (ptr == NULL) {
 		log_error("cutils", "mem", NULL, "out of memory");
 		return NULL;
 	}
 
-	mem_stats_realloc(old_size, new_size);
+	if (s_tags) {
+		tag_stats(ptr, old_size, new_size, 1);
+		ptr = (byte *)ptr + MEM_HDR;
+	}
+
+	stats_realloc(old_size, new_size);
 
 	return ptr;
 }
@@ -203,33 +543,202 @@ int mem_cmp(const void *l, const void *r, size_t size)
 	return memcmp(l, r, size);
 }
 
+static void swap_words(byte *p1, byte *p2, size_t size)
+{
+	size_t i = 0;
+
+#if defined(MEM_SSE2)
+	for (; i + 16 <= size; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(p1 + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(p2 + i));
+		_mm_storeu_si128((__m128i *)(p1 + i), b);
+		_mm_storeu_si128((__m128i *)(p2 + i), a);
+	}
+#endif
+
+	for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+		u64 a, b;
+		memcpy(&a, p1 + i, sizeof(u64));
+		memcpy(&b, p2 + i, sizeof(u64));
+		memcpy(p1 + i, &b, sizeof(u64));
+		memcpy(p2 + i, &a, sizeof(u64));
+	}
+
+	for (; i + sizeof(u32) <= size; i += sizeof(u32)) {
+		u32 a, b;
+		memcpy(&a, p1 + i, sizeof(u32));
+		memcpy(&b, p2 + i, sizeof(u32));
+		memcpy(p1 + i, &b, sizeof(u32));
+		memcpy(p2 + i, &a, sizeof(u32));
+	}
+
+	for (; i < size; i++) {
+		byte tmp = p1[i];
+		p1[i]	 = p2[i];
+		p2[i]	 = tmp;
+	}
+}
+
+#if defined(MEM_AVX2)
+__attribute__((target("avx2"))) static void swap_avx2(byte *p1, byte *p2, size_t size)
+{
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		__m256i a = _mm256_loadu_si256((const __m256i *)(p1 + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(p2 + i));
+		_mm256_storeu_si256((__m256i *)(p1 + i), b);
+		_mm256_storeu_si256((__m256i *)(p2 + i), a);
+	}
+
+	swap_words(p1 + i, p2 + i, size - i);
+}
+#endif
+
+typedef void (*swap_fn)(byte *p1, byte *p2, size_t size);
+
+static void swap_init(byte *p1, byte *p2, size_t size);
+
+static swap_fn s_swap = swap_init;
+
+static void swap_init(byte *p1, byte *p2, size_t size)
+{
+	swap_fn fn = swap_words;
+#if defined(MEM_AVX2)
+	if (__builtin_cpu_supports("avx2")) {
+		fn = swap_avx2;
+	}
+#endif
+	s_swap = fn;
+	fn(p1, p2, size);
+}
+
 int mem_swap(void *ptr1, void *ptr2, size_t size)
 {
 	if (ptr1 == NULL || ptr2 == NULL) {
 		return 1;
 	}
 
-	unsigned char *byte_ptr1 = (unsigned char *)ptr1;
-	unsigned char *byte_ptr2 = (unsigned char *)ptr2;
-
-	for (size_t i = 0; i < size; i++) {
-		unsigned char temp = byte_ptr1[i];
-		byte_ptr1[i]	   = byte_ptr2[i];
-		byte_ptr2[i]	   = temp;
+	if (size < 32) {
+		swap_words(ptr1, ptr2, size);
+	} else {
+		s_swap(ptr1, ptr2, size);
 	}
 
 	return 0;
 }
 
+int mem_eq(const void *l, const void *r, size_t size)
+{
+	if (l == r) {
+		return 1;
+	}
+
+	if (l == NULL || r == NULL) {
+		return 0;
+	}
+
+	const byte *a = l;
+	const byte *b = r;
+
+	if (size <= 16) {
+		if (size >= sizeof(u64)) {
+			u64 a0, a1, b0, b1;
+			memcpy(&a0, a, sizeof(u64));
+			memcpy(&b0, b, sizeof(u64));
+			memcpy(&a1, a + size - sizeof(u64), sizeof(u64));
+			memcpy(&b1, b + size - sizeof(u64), sizeof(u64));
+			return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+		}
+
+		if (size >= sizeof(u32)) {
+			u32 a0, a1, b0, b1;
+			memcpy(&a0, a, sizeof(u32));
+			memcpy(&b0, b, sizeof(u32));
+			memcpy(&a1, a + size - sizeof(u32), sizeof(u32));
+			memcpy(&b1, b + size - sizeof(u32), sizeof(u32));
+			return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+		}
+
+		for (size_t i = 0; i < size; i++) {
+			if (a[i] != b[i]) {
+				return 0;
+			}
+		}
+
+		return 1;
+	}
+
+	return memcmp(l, r, size) == 0;
+}
+
+void *mem_find(const void *ptr, size_t size, const void *pat, size_t len)
+{
+	if (ptr == NULL || pat == NULL || len == 0 || len > size) {
+		return NULL;
+	}
+
+	const byte *cur	 = ptr;
+	const byte *end	 = cur + size - len + 1;
+	const byte first = *(const byte *)pat;
+
+	while (cur < end) {
+		cur = memchr(cur, first, (size_t)(end - cur));
+		if (cur == NULL) {
+			return NULL;
+		}
+
+		if (mem_eq(cur + 1, (const byte *)pat + 1, len - 1)) {
+			return (void *)cur;
+		}
+
+		cur++;
+	}
+
+	return NULL;
+}
+
+void *mem_fill(void *dst, size_t size, const void *pat, size_t len)
+{
+	if (dst == NULL || pat == NULL || len == 0) {
+		return NULL;
+	}
+
+	if (len == 1) {
+		return memset(dst, *(const byte *)pat, size);
+	}
+
+	byte *data  = dst;
+	size_t done = len < size ? len : size;
+	memcpy(data, pat, done);
+
+	while (done < size) {
+		size_t cnt = done < size - done ? done : size - done;
+		memcpy(data + done, data, cnt);
+		done += cnt;
+	}
+
+	return dst;
+}
+
 void mem_free(void *memory, size_t size)
 {
 	if (memory == NULL) {
 		return;
 	}
 
-	mem_stats_free(size);
+	stats_free(size);
 
-	free(memory);
+	if (s_tags) {
+		memory = (byte *)memory - MEM_HDR;
+		tag_stats(memory, size, 0, 0);
+		size += MEM_HDR;
+	}
+
+	if (s_tcache) {
+		tcache_free(memory, size);
+	} else {
+		free(memory);
+	}
 }
 
 void mem_oom(int oom)
@@ -237,3 +746,207 @@ void mem_oom(int oom)
 	s_oom = oom;
 	log_set_quiet(0, oom ? 1 : 0);
 }
+
+int mem_tcache(int enable)
+{
+	if (s_tcache == (enable ? 1 : 0)) {
+		return 0;
+	}
+
+	mem_merge();
+
+	const mem_stats_t *stats = mem_stats_get();
+	if (enable && stats && stats->mem > 0) {
+		log_error("cutils", "mem", NULL, "can not enable thread cache: %zu bytes not freed", stats->mem);
+		return 1;
+	}
+
+	if (s_tcache) {
+		mem_tcache_flush();
+
+		lock_acquire(&s_lock);
+		for (int cls = 0; cls < TCACHE_CLASSES; cls++) {
+			tcache_pool_t *pool = &s_pool[cls];
+			while (pool->free) {
+				void *ptr  = pool->free;
+				pool->free = *(void **)ptr;
+				free(ptr);
+			}
+			pool->cnt = 0;
+		}
+		lock_release(&s_lock);
+	}
+
+	s_tcache = enable ? 1 : 0;
+
+	return 0;
+}
+
+void mem_tcache_flush()
+{
+	if (!s_tcache) {
+		return;
+	}
+
+	for (int cls = 0; cls < TCACHE_CLASSES; cls++) {
+		tcache_drain(cls, TCACHE_MAG_SIZE);
+	}
+
+	mem_merge();
+}
+
+void mem_shards(int enable)
+{
+	mem_merge();
+
+	if (enable) {
+		atom_add(&s_shards, 1);
+	} else if (atom_load(&s_shards) > 0) {
+		atom_add(&s_shards, (size_t)-1);
+	}
+}
+
+void mem_merge()
+{
+	mem_stats_t *stats = (mem_stats_t *)mem_stats_get();
+
+	lock_acquire(&s_lock);
+	for (int i = 0; i < MEM_SHARDS; i++) {
+		shard_t *shard = &s_shard[i];
+
+		size_t added	= atom_xchg(&shard->added, 0);
+		size_t freed	= atom_xchg(&shard->freed, 0);
+		size_t total	= atom_xchg(&shard->total, 0);
+		size_t allocs	= atom_xchg(&shard->allocs, 0);
+		size_t reallocs = atom_xchg(&shard->reallocs, 0);
+
+		for (int j = 0; j < MEM_TAGS; j++) {
+			tag_stats_t *tag     = &shard->tags[j];
+			mem_tag_stats_t *sum = &s_tag_sum[j];
+
+			sum->bytes += atom_xchg(&tag->bytes, 0);
+			sum->live += atom_xchg(&tag->live, 0);
+			sum->allocs += atom_xchg(&tag->allocs, 0);
+			sum->reallocs += atom_xchg(&tag->reallocs, 0);
+		}
+		s_tag_lost += atom_xchg(&shard->tags_lost, 0);
+
+		if (stats == NULL) {
+			continue;
+		}
+
+		stats->mem += added - freed;
+		stats->total += total;
+		stats->allocs += allocs;
+		stats->reallocs += reallocs;
+		if (stats->mem > stats->peak) {
+			stats->peak = stats->mem;
+		}
+	}
+
+	for (int j = 0; j < MEM_TAGS; j++) {
+		mem_tag_stats_t *sum = &s_tag_sum[j];
+		if (sum->live > sum->peak) {
+			sum->peak = sum->live;
+		}
+	}
+	lock_release(&s_lock);
+}
+
+int mem_tags(int enable)
+{
+	if (s_tags == (enable ? 1 : 0)) {
+		return 0;
+	}
+
+	mem_merge();
+
+	const mem_stats_t *stats = mem_stats_get();
+	if (stats && stats->mem > 0) {
+		log_error("cutils", "mem", NULL, "can not %s tag tracking: %zu bytes not freed", enable ? "enable" : "disable", stats->mem);
+		return 1;
+	}
+
+	s_tags = enable ? 1 : 0;
+
+	return 0;
+}
+
+void mem_tags_reset()
+{
+	mem_merge();
+
+	lock_acquire(&s_lock);
+	for (int i = 0; i < MEM_TAGS; i++) {
+		s_tag_names[i] = NULL;
+		s_tag_sum[i]   = (mem_tag_stats_t){0};
+	}
+	s_tag_lost = 0;
+	atom_add(&s_tag_gen, 1);
+	lock_release(&s_lock);
+}
+
+const char *mem_tag(const char *tag)
+{
+	const char *prev = s_tag;
+	s_tag		 = tag;
+	s_tag_idx_gen	 = 0;
+	return prev;
+}
+
+int mem_tag_get(const char *tag, mem_tag_stats_t *stats)
+{
+	if (tag == NULL || stats == NULL) {
+		return 1;
+	}
+
+	mem_merge();
+
+	for (int i = 0; i < MEM_TAGS && s_tag_names[i]; i++) {
+		if (s_tag_names[i] == tag) {
+			*stats	   = s_tag_sum[i];
+			stats->tag = tag;
+			return 0;
+		}
+	}
+
+	*stats = (mem_tag_stats_t){.tag = tag};
+	return 1;
+}
+
+size_t mem_print_tags(dst_t dst)
+{
+	mem_merge();
+
+	mem_tag_stats_t tags[MEM_TAGS] = {0};
+	int cnt				   = 0;
+
+	for (int i = 0; i < MEM_TAGS && s_tag_names[i]; i++) {
+		tags[cnt]     = s_tag_sum[i];
+		tags[cnt].tag = s_tag_names[i];
+		cnt++;
+	}
+
+	for (int i = 1; i < cnt; i++) {
+		for (int j = i; j > 0 && tags[j].bytes > tags[j - 1].bytes; j--) {
+			mem_tag_stats_t tmp = tags[j];
+			tags[j]		    = tags[j - 1];
+			tags[j - 1]	    = tmp;
+		}
+	}
+
+	size_t off = dst.off;
+
+	dst.off += dputs(dst, STRV("memory tags:\n"));
+	for (int i = 0; i < cnt; i++) {
+		dst.off += dputf(dst, "    %-16s allocs: %-8zu reallocs: %-8zu live: %-8zu peak: %-8zu bytes: ", tags[i].tag, tags[i].allocs,
+				 tags[i].reallocs, tags[i].live, tags[i].peak);
+		dst.off += print_mem(tags[i].bytes, dst);
+	}
+
+	if (s_tag_lost > 0) {
+		dst.off += dputf(dst, "    %zu tagged allocations not tracked: more than %d tags\n", s_tag_lost, MEM_TAGS);
+	}
+
+	return dst.off - off;
+}
@@ -0,0 +1,350 @@
+#include "odict.h"
+
+#include "hash.h"
+#include "log.h"
+#include "mem.h"
+
+#define ODICT_MIN_CAP	8
+#define ODICT_MIN_INDEX 8
+
+#define INDEX_EMPTY 0
+
+static uint index_cap(uint cnt)
+{
+	uint cap = ODICT_MIN_INDEX;
+	while (cnt > cap / 4 * 3) {
+		cap *= 2;
+	}
+
+	return cap;
+}
+
+static u32 hash_key(const odict_t *map, const void *key, size_t ksize)
+{
+	u64 hash = map->hash ? map->hash(key, ksize, map->priv) : hash_bytes(key, ksize, map->seed);
+	return (u32)(hash ^ hash >> 32);
+}
+
+static int key_eq(const odict_t *map, const odict_entry_t *entry, const void *key, size_t ksize)
+{
+	if (map->eq) {
+		return map->eq(entry->key, entry->ksize, key, ksize, map->priv);
+	}
+
+	return entry->ksize == ksize && mem_eq(entry->key, key, ksize);
+}
+
+static void index_build(odict_t *map)
+{
+	uint mask = map->icap - 1;
+
+	mem_set(map->index, INDEX_EMPTY, map->icap * sizeof(uint));
+
+	for (uint id = 0; id < map->used; id++) {
+		if (map->entries[id].key == NULL) {
+			continue;
+		}
+
+		uint i = map->entries[id].hash & mask;
+		while (map->index[i] != INDEX_EMPTY) {
+			i = (i + 1) & mask;
+		}
+
+		map->index[i] = id + 1;
+	}
+}
+
+static int index_resize(odict_t *map, uint icap)
+{
+	uint *index = alloc_alloc(&map->alloc, icap * sizeof(uint));
+	if (index == NULL) {
+		log_error("cutils", "odict", NULL, "failed to allocate index");
+		return 1;
+	}
+
+	if (map->index) {
+		alloc_free(&map->alloc, map->index, map->icap * sizeof(uint));
+	}
+
+	map->index = index;
+	map->icap  = icap;
+	index_build(map);
+
+	return 0;
+}
+
+static uint index_find(const odict_t *map, const void *key, size_t ksize, u32 hash)
+{
+	uint mask = map->icap - 1;
+
+	for (uint i = hash & mask;; i = (i + 1) & mask) {
+		uint id = map->index[i];
+		if (id == INDEX_EMPTY) {
+			return i;
+		}
+
+		const odict_entry_t *entry = &map->entries[id - 1];
+		if (entry->hash == hash && key_eq(map, entry, key, ksize)) {
+			return i;
+		}
+	}
+}
+
+odict_t *odict_init(odict_t *map, uint cap, alloc_t alloc)
+{
+	if (map == NULL) {
+		return NULL;
+	}
+
+	cap = cap < ODICT_MIN_CAP ? ODICT_MIN_CAP : cap;
+
+	map->alloc   = alloc;
+	map->entries = alloc_alloc(&map->alloc, cap * sizeof(odict_entry_t));
+	if (map->entries == NULL) {
+		log_error("cutils", "odict", NULL, "failed to allocate entries");
+		return NULL;
+	}
+
+	map->cap   = cap;
+	map->used  = 0;
+	map->cnt   = 0;
+	map->index = NULL;
+	map->gen   = 0;
+	map->seed  = hash_seed();
+	map->hash  = NULL;
+	map->eq	   = NULL;
+	map->priv  = NULL;
+
+	if (index_resize(map, index_cap(cap))) {
+		alloc_free(&map->alloc, map->entries, cap * sizeof(odict_entry_t));
+		map->entries = NULL;
+		return NULL;
+	}
+
+	return map;
+}
+
+int odict_set_hash(odict_t *map, hash_cb hash, hash_eq_cb eq, const void *priv)
+{
+	if (map == NULL) {
+		return 1;
+	}
+
+	if (map->cnt > 0) {
+		log_error("cutils", "odict", NULL, "hash can only be changed on an empty dict");
+		return 1;
+	}
+
+	map->hash = hash;
+	map->eq	  = eq;
+	map->priv = priv;
+
+	return 0;
+}
+
+void odict_free(odict_t *map)
+{
+	if (map == NULL || map->entries == NULL) {
+		return;
+	}
+
+	alloc_free(&map->alloc, map->index, map->icap * sizeof(uint));
+	alloc_free(&map->alloc, map->entries, map->cap * sizeof(odict_entry_t));
+	map->entries = NULL;
+	map->index   = NULL;
+	map->cap     = 0;
+	map->icap    = 0;
+	map->used    = 0;
+	map->cnt     = 0;
+}
+
+void odict_reset(odict_t *map)
+{
+	if (map == NULL || map->entries == NULL) {
+		return;
+	}
+
+	mem_set(map->index, INDEX_EMPTY, map->icap * sizeof(uint));
+	map->used = 0;
+	map->cnt  = 0;
+	map->gen++;
+}
+
+int odict_compact(odict_t *map)
+{
+	if (map == NULL || map->entries == NULL) {
+		return 1;
+	}
+
+	if (map->cnt == map->used) {
+		return 0;
+	}
+
+	uint used = 0;
+	for (uint id = 0; id < map->used; id++) {
+		if (map->entries[id].key != NULL) {
+			map->entries[used++] = map->entries[id];
+		}
+	}
+
+	map->used = used;
+	map->gen++;
+	index_build(map);
+
+	return 0;
+}
+
+static int entries_reserve(odict_t *map)
+{
+	if (map->used < map->cap) {
+		return 0;
+	}
+
+	if (map->used - map->cnt >= map->used / 4) {
+		return odict_compact(map);
+	}
+
+	size_t old_size = map->cap * sizeof(odict_entry_t);
+	if (alloc_realloc(&map->alloc, (void **)&map->entries, &old_size, map->cap * 2 * sizeof(odict_entry_t))) {
+		log_error("cutils", "odict", NULL, "failed to resize entries");
+		return 1;
+	}
+
+	map->cap *= 2;
+
+	return 0;
+}
+
+int odict_set(odict_t *map, const void *key, size_t ksize, void *value)
+{
+	if (map == NULL || map->entries == NULL || key == NULL) {
+		return 1;
+	}
+
+	u32 hash = hash_key(map, key, ksize);
+	uint i	 = index_find(map, key, ksize, hash);
+	if (map->index[i] != INDEX_EMPTY) {
+		map->entries[map->index[i] - 1].value = value;
+		return 0;
+	}
+
+	if (entries_reserve(map)) {
+		return 1;
+	}
+
+	if (map->cnt + 1 > map->icap / 4 * 3) {
+		if (index_resize(map, map->icap * 2)) {
+			return 1;
+		}
+	}
+
+	map->entries[map->used] = (odict_entry_t){
+		.key   = key,
+		.ksize = ksize,
+		.hash  = hash,
+		.value = value,
+	};
+
+	map->used++;
+	map->cnt++;
+
+	map->index[index_find(map, key, ksize, hash)] = map->used;
+
+	return 0;
+}
+
+int odict_get(const odict_t *map, const void *key, size_t ksize, void **value)
+{
+	if (map == NULL || map->entries == NULL || key == NULL) {
+		return 1;
+	}
+
+	uint id = map->index[index_find(map, key, ksize, hash_key(map, key, ksize))];
+	if (id == INDEX_EMPTY) {
+		return 1;
+	}
+
+	if (value) {
+		*value = map->entries[id - 1].value;
+	}
+
+	return 0;
+}
+
+int odict_remove(odict_t *map, const void *key, size_t ksize, void **value)
+{
+	if (map == NULL || map->entries == NULL || key == NULL) {
+		return 1;
+	}
+
+	uint hole = index_find(map, key, ksize, hash_key(map, key, ksize));
+	uint id	  = map->index[hole];
+	if (id == INDEX_EMPTY) {
+		return 1;
+	}
+
+	odict_entry_t *entry = &map->entries[id - 1];
+	if (value) {
+		*value = entry->value;
+	}
+
+	*entry = (odict_entry_t){0};
+	map->cnt--;
+
+	uint mask = map->icap - 1;
+	for (uint i = (hole + 1) & mask; map->index[i] != INDEX_EMPTY; i = (i + 1) & mask) {
+		uint home = map->entries[map->index[i] - 1].hash & mask;
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			map->index[hole] = map->index[i];
+			hole		 = i;
+		}
+	}
+
+	map->index[hole] = INDEX_EMPTY;
+
+	return 0;
+}
+
+odict_entry_t *odict_next(const odict_t *map, uint *i)
+{
+	if (map == NULL || i == NULL) {
+		return NULL;
+	}
+
+	for (; *i < map->used; (*i)++) {
+		if (map->entries[*i].key != NULL) {
+			return &map->entries[*i];
+		}
+	}
+
+	return NULL;
+}
+
+odict_snap_t odict_snap(const odict_t *map)
+{
+	if (map == NULL) {
+		return (odict_snap_t){0};
+	}
+
+	return (odict_snap_t){.used = map->used, .gen = map->gen};
+}
+
+int odict_snap_valid(const odict_t *map, const odict_snap_t *snap)
+{
+	return map != NULL && snap != NULL && map->entries != NULL && snap->gen == map->gen && snap->used <= map->used;
+}
+
+odict_entry_t *odict_snap_next(const odict_t *map, const odict_snap_t *snap, uint *i)
+{
+	if (i == NULL || !odict_snap_valid(map, snap)) {
+		return NULL;
+	}
+
+	for (; *i < snap->used; (*i)++) {
+		if (map->entries[*i].key != NULL) {
+			return &map->entries[*i];
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,180 @@
+#include "slab.h"
+
+#include "log.h"
+#include "mem.h"
+
+struct slab_page_s {
+	slab_page_t *next;
+	size_t size;
+};
+
+#define PAGE_HEADER ((sizeof(slab_page_t) + SLAB_MIN_SIZE - 1) & ~(size_t)(SLAB_MIN_SIZE - 1))
+
+#define CLASS_SIZE(_cls) ((size_t)SLAB_MIN_SIZE << (_cls))
+
+static int get_class(size_t size)
+{
+	int cls = 0;
+	while (cls < SLAB_CLASSES && CLASS_SIZE(cls) < size) {
+		cls++;
+	}
+
+	return cls;
+}
+
+slab_t *slab_init(slab_t *slab, size_t page_size, alloc_t alloc)
+{
+	if (slab == NULL) {
+		return NULL;
+	}
+
+	for (int i = 0; i < SLAB_CLASSES; i++) {
+		slab->free[i] = NULL;
+	}
+
+	slab->pages	= NULL;
+	slab->page_size = page_size;
+	slab->alloc	= alloc;
+
+	return slab;
+}
+
+void slab_free(slab_t *slab)
+{
+	if (slab == NULL) {
+		return;
+	}
+
+	slab_page_t *page = slab->pages;
+	while (page) {
+		slab_page_t *next = page->next;
+		alloc_free(&slab->alloc, page, page->size);
+		page = next;
+	}
+
+	for (int i = 0; i < SLAB_CLASSES; i++) {
+		slab->free[i] = NULL;
+	}
+
+	slab->pages = NULL;
+}
+
+static int slab_page(slab_t *slab, int cls, uint cnt)
+{
+	size_t size	 = CLASS_SIZE(cls);
+	size_t page_size = PAGE_HEADER + cnt * size;
+
+	slab_page_t *page = alloc_alloc(&slab->alloc, page_size);
+	if (page == NULL) {
+		log_error("cutils", "slab", NULL, "failed to allocate page");
+		return 1;
+	}
+
+	page->next  = slab->pages;
+	page->size  = page_size;
+	slab->pages = page;
+
+	byte *obj = (byte *)page + PAGE_HEADER + cnt * size;
+	for (uint i = 0; i < cnt; i++) {
+		obj -= size;
+		*(void **)obj	= slab->free[cls];
+		slab->free[cls] = obj;
+	}
+
+	return 0;
+}
+
+int slab_reserve(slab_t *slab, size_t size, uint cnt)
+{
+	if (slab == NULL) {
+		return 1;
+	}
+
+	int cls = get_class(size);
+	if (cls >= SLAB_CLASSES) {
+		log_error("cutils", "slab", NULL, "size too large: %zu", size);
+		return 1;
+	}
+
+	if (cnt == 0) {
+		return 0;
+	}
+
+	return slab_page(slab, cls, cnt);
+}
+
+void *alloc_alloc_slab(alloc_t *alloc, size_t size)
+{
+	slab_t *slab = alloc->priv;
+	if (slab == NULL) {
+		return NULL;
+	}
+
+	int cls = get_class(size);
+	if (cls >= SLAB_CLASSES) {
+		return alloc_alloc(&slab->alloc, size);
+	}
+
+	if (slab->free[cls] == NULL) {
+		size_t cnt = slab->page_size / CLASS_SIZE(cls);
+		if (slab_page(slab, cls, cnt > 0 ? (uint)cnt : 1)) {
+			return NULL;
+		}
+	}
+
+	void *ptr	= slab->free[cls];
+	slab->free[cls] = *(void **)ptr;
+
+	return ptr;
+}
+
+int alloc_realloc_slab(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size)
+{
+	slab_t *slab = alloc->priv;
+	if (slab == NULL) {
+		return 1;
+	}
+
+	int old_cls = get_class(*old_size);
+	int new_cls = get_class(new_size);
+
+	if (old_cls >= SLAB_CLASSES && new_cls >= SLAB_CLASSES) {
+		return alloc_realloc(&slab->alloc, ptr, old_size, new_size);
+	}
+
+	if (old_cls == new_cls) {
+		*old_size = new_size;
+		return 0;
+	}
+
+	void *data = alloc_alloc_slab(alloc, new_size);
+	if (data == NULL) {
+		log_error("cutils", "slab", NULL, "failed to reallocate memory");
+		return 1;
+	}
+
+	mem_copy(data, new_size, *ptr, *old_size < new_size ? *old_size : new_size);
+	alloc_free_slab(alloc, *ptr, *old_size);
+
+	*ptr	  = data;
+	*old_size = new_size;
+
+	return 0;
+}
+
+void alloc_free_slab(alloc_t *alloc, void *ptr, size_t size)
+{
+	slab_t *slab = alloc->priv;
+	if (slab == NULL || ptr == NULL) {
+		return;
+	}
+
+	int cls = get_class(size);
+	if (cls >= SLAB_CLASSES) {
+		alloc_free(&slab->alloc, ptr, size);
+		return;
+	}
+
+	*(void **)ptr	= slab->free[cls];
+	slab->free[cls] = ptr;
+}
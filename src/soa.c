@@ -0,0 +1,202 @@
+#include "soa.h"
+
+#include "log.h"
+#include "mem.h"
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+soa_t *soa_init(soa_t *soa, uint cap, const size_t *sizes, uint ncols, alloc_t alloc)
+{
+	if (soa == NULL || sizes == NULL || ncols == 0) {
+		return NULL;
+	}
+
+	soa_col_t *cols = alloc_alloc(&alloc, ncols * sizeof(soa_col_t));
+	if (cols == NULL) {
+		log_error("cutils", "soa", NULL, "failed to allocate columns");
+		return NULL;
+	}
+
+	for (uint i = 0; i < ncols; i++) {
+		cols[i] = (soa_col_t){.size = sizes[i]};
+	}
+
+	soa->cols  = cols;
+	soa->ncols = ncols;
+	soa->cap   = 0;
+	soa->cnt   = 0;
+	soa->alloc = alloc;
+	soa->grow  = (grow_t){0};
+
+	if (soa_resize(soa, cap)) {
+		soa_free(soa);
+		return NULL;
+	}
+
+	return soa;
+}
+
+void soa_free(soa_t *soa)
+{
+	if (soa == NULL || soa->cols == NULL) {
+		return;
+	}
+
+	for (uint i = 0; i < soa->ncols; i++) {
+		if (soa->cols[i].data) {
+			alloc_free(&soa->alloc, soa->cols[i].data, soa->cols[i].cap * soa->cols[i].size);
+		}
+	}
+
+	alloc_free(&soa->alloc, soa->cols, soa->ncols * sizeof(soa_col_t));
+	soa->cols  = NULL;
+	soa->ncols = 0;
+	soa->cap   = 0;
+	soa->cnt   = 0;
+}
+
+void soa_reset(soa_t *soa, uint cnt)
+{
+	if (soa == NULL) {
+		return;
+	}
+
+	if (cnt > soa->cnt) {
+		cnt = soa->cnt;
+	}
+
+	soa->cnt = cnt;
+}
+
+int soa_resize(soa_t *soa, uint cap)
+{
+	if (soa == NULL) {
+		return 1;
+	}
+
+	if (cap <= soa->cap) {
+		return 0;
+	}
+
+	for (uint i = 0; i < soa->ncols; i++) {
+		soa_col_t *col = &soa->cols[i];
+		if (col->cap >= cap) {
+			continue;
+		}
+
+		if (col->data == NULL) {
+			col->data = alloc_alloc(&soa->alloc, cap * col->size);
+			if (col->data == NULL) {
+				log_error("cutils", "soa", NULL, "failed to resize column: %d", i);
+				return 1;
+			}
+			col->cap = cap;
+			continue;
+		}
+
+		size_t old_size = col->cap * col->size;
+		if (alloc_realloc(&soa->alloc, &col->data, &old_size, cap * col->size)) {
+			log_error("cutils", "soa", NULL, "failed to resize column: %d", i);
+			return 1;
+		}
+		col->cap = cap;
+	}
+
+	soa->cap = cap;
+
+	return 0;
+}
+
+void soa_set_grow(soa_t *soa, grow_t grow)
+{
+	if (soa == NULL) {
+		return;
+	}
+
+	soa->grow = grow;
+}
+
+int soa_add(soa_t *soa, uint *id)
+{
+	if (soa == NULL) {
+		return 1;
+	}
+
+	if (soa->cnt >= soa->cap && soa_resize(soa, (uint)MIN(grow_next(&soa->grow, soa->cap, soa->cnt + 1), (uint)-1))) {
+		log_error("cutils", "soa", NULL, "failed to add row");
+		return 1;
+	}
+
+	if (id) {
+		*id = soa->cnt;
+	}
+
+	soa->cnt++;
+
+	return 0;
+}
+
+int soa_addv(soa_t *soa, const void *const *values, uint *id)
+{
+	if (soa == NULL || values == NULL) {
+		return 1;
+	}
+
+	uint row;
+	if (soa_add(soa, &row)) {
+		return 1;
+	}
+
+	for (uint i = 0; i < soa->ncols; i++) {
+		if (values[i]) {
+			mem_copy((byte *)soa->cols[i].data + row * soa->cols[i].size, soa->cols[i].size, values[i], soa->cols[i].size);
+		}
+	}
+
+	if (id) {
+		*id = row;
+	}
+
+	return 0;
+}
+
+void *soa_col(const soa_t *soa, uint col)
+{
+	if (soa == NULL) {
+		return NULL;
+	}
+
+	if (col >= soa->ncols) {
+		log_error("cutils", "soa", NULL, "invalid column: %d", col);
+		return NULL;
+	}
+
+	return soa->cols[col].data;
+}
+
+void *soa_get(const soa_t *soa, uint col, uint id)
+{
+	if (soa == NULL) {
+		return NULL;
+	}
+
+	if (col >= soa->ncols || id >= soa->cnt) {
+		log_error("cutils", "soa", NULL, "invalid cell: %d:%d", col, id);
+		return NULL;
+	}
+
+	return (byte *)soa->cols[col].data + id * soa->cols[col].size;
+}
+
+int soa_row(const soa_t *soa, uint id, void **values)
+{
+	if (soa == NULL || values == NULL || id >= soa->cnt) {
+		return 1;
+	}
+
+	for (uint i = 0; i < soa->ncols; i++) {
+		values[i] = (byte *)soa->cols[i].data + id * soa->cols[i].size;
+	}
+
+	return 0;
+}
@@ -0,0 +1,221 @@
+#include "sync.h"
+
+#include "log.h"
+
+#if defined(C_WIN)
+	#include <windows.h>
+#else
+	#include <sched.h>
+	#include <unistd.h>
+#endif
+
+#define SPIN_COUNT 64
+
+static int try_acquire(lock_t *lock)
+{
+#if defined(C_WIN)
+	return InterlockedExchange(&lock->locked, 1) == 0;
+#else
+	return __atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE) == 0;
+#endif
+}
+
+static int is_locked(lock_t *lock)
+{
+#if defined(C_WIN)
+	return InterlockedCompareExchange(&lock->locked, 0, 0) != 0;
+#else
+	return __atomic_load_n(&lock->locked, __ATOMIC_RELAXED) != 0;
+#endif
+}
+
+static void yield()
+{
+#if defined(C_WIN)
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+void lock_acquire(lock_t *lock)
+{
+	if (lock == NULL) {
+		return;
+	}
+
+	for (int spin = 0; !try_acquire(lock); spin++) {
+		while (is_locked(lock)) {
+			if (spin++ >= SPIN_COUNT) {
+				yield();
+			}
+		}
+	}
+}
+
+void lock_release(lock_t *lock)
+{
+	if (lock == NULL) {
+		return;
+	}
+
+#if defined(C_WIN)
+	InterlockedExchange(&lock->locked, 0);
+#else
+	__atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+#if defined(C_WIN)
+	#if defined(_WIN64)
+		#define ATOM_T		   LONG64
+		#define ATOM_ADD(_v, _a)   InterlockedExchangeAdd64(_v, _a)
+		#define ATOM_XCHG(_v, _s)  InterlockedExchange64(_v, _s)
+		#define ATOM_CAS(_v, _s, _e) InterlockedCompareExchange64(_v, _s, _e)
+	#else
+		#define ATOM_T		   LONG
+		#define ATOM_ADD(_v, _a)   InterlockedExchangeAdd(_v, _a)
+		#define ATOM_XCHG(_v, _s)  InterlockedExchange(_v, _s)
+		#define ATOM_CAS(_v, _s, _e) InterlockedCompareExchange(_v, _s, _e)
+	#endif
+#endif
+
+size_t atom_add(volatile size_t *val, size_t add)
+{
+#if defined(C_WIN)
+	return (size_t)ATOM_ADD((volatile ATOM_T *)val, (ATOM_T)add) + add;
+#else
+	return __atomic_add_fetch(val, add, __ATOMIC_RELAXED);
+#endif
+}
+
+size_t atom_xchg(volatile size_t *val, size_t set)
+{
+#if defined(C_WIN)
+	return (size_t)ATOM_XCHG((volatile ATOM_T *)val, (ATOM_T)set);
+#else
+	return __atomic_exchange_n(val, set, __ATOMIC_ACQ_REL);
+#endif
+}
+
+size_t atom_load(const volatile size_t *val)
+{
+#if defined(C_WIN)
+	return *val;
+#else
+	return __atomic_load_n(val, __ATOMIC_RELAXED);
+#endif
+}
+
+int atom_cas(volatile size_t *val, size_t expected, size_t desired)
+{
+#if defined(C_WIN)
+	return (size_t)ATOM_CAS((volatile ATOM_T *)val, (ATOM_T)desired, (ATOM_T)expected) == expected;
+#else
+	return __atomic_compare_exchange_n(val, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+#endif
+}
+
+int atom_cas_ptr(void *volatile *ptr, void *expected, void *desired)
+{
+#if defined(C_WIN)
+	return InterlockedCompareExchangePointer(ptr, desired, expected) == expected;
+#else
+	return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+u64 atom_load64(const volatile u64 *val)
+{
+#if defined(C_WIN)
+	return (u64)InterlockedCompareExchange64((volatile LONG64 *)val, 0, 0);
+#else
+	return __atomic_load_n(val, __ATOMIC_ACQUIRE);
+#endif
+}
+
+int atom_cas64(volatile u64 *val, u64 expected, u64 desired)
+{
+#if defined(C_WIN)
+	return (u64)InterlockedCompareExchange64((volatile LONG64 *)val, (LONG64)desired, (LONG64)expected) == expected;
+#else
+	return __atomic_compare_exchange_n(val, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+#if defined(C_WIN)
+static DWORD WINAPI thread_main(LPVOID arg)
+{
+	thread_t *thread = arg;
+	thread->cb(thread->priv);
+	return 0;
+}
+#else
+static void *thread_main(void *arg)
+{
+	thread_t *thread = arg;
+	thread->cb(thread->priv);
+	return NULL;
+}
+#endif
+
+int thread_create(thread_t *thread, thread_cb cb, void *priv)
+{
+	if (thread == NULL || cb == NULL) {
+		return 1;
+	}
+
+	thread->cb   = cb;
+	thread->priv = priv;
+
+#if defined(C_WIN)
+	thread->handle = CreateThread(NULL, 0, thread_main, thread, 0, NULL);
+	if (thread->handle == NULL) {
+		log_error("cutils", "sync", NULL, "failed to create thread: %lu", GetLastError());
+		return 1;
+	}
+#else
+	int err = pthread_create(&thread->handle, NULL, thread_main, thread);
+	if (err != 0) {
+		log_error("cutils", "sync", NULL, "failed to create thread: %d", err);
+		return 1;
+	}
+#endif
+
+	return 0;
+}
+
+int thread_join(thread_t *thread)
+{
+	if (thread == NULL) {
+		return 1;
+	}
+
+#if defined(C_WIN)
+	if (WaitForSingleObject(thread->handle, INFINITE) != WAIT_OBJECT_0) {
+		log_error("cutils", "sync", NULL, "failed to join thread: %lu", GetLastError());
+		return 1;
+	}
+	CloseHandle(thread->handle);
+#else
+	int err = pthread_join(thread->handle, NULL);
+	if (err != 0) {
+		log_error("cutils", "sync", NULL, "failed to join thread: %d", err);
+		return 1;
+	}
+#endif
+
+	return 0;
+}
+
+unsigned int thread_cpus()
+{
+#if defined(C_WIN)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+#else
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	return cpus > 0 ? (unsigned int)cpus : 1;
+#endif
+}
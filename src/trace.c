@@ -0,0 +1,434 @@
+#include "trace.h"
+
+#include "log.h"
+#include "mem.h"
+#include "platform.h"
+
+#if defined(C_WIN)
+	#include <windows.h>
+#elif defined(__GLIBC__)
+	#include <execinfo.h>
+#endif
+
+#define TRACE_MIN_CAP 16
+#define TRACE_SKIP    2
+
+#if defined(_MSC_VER)
+	#define TRACE_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__)
+	#define TRACE_NOINLINE __attribute__((noinline))
+#else
+	#define TRACE_NOINLINE
+#endif
+
+// skips capture() and the alloc_*_trace wrapper frames
+static TRACE_NOINLINE int capture(void **frames)
+{
+#if defined(C_WIN)
+	return CaptureStackBackTrace(TRACE_SKIP, TRACE_DEPTH, frames, NULL);
+#elif defined(__GLIBC__)
+	void *buf[TRACE_SKIP + TRACE_DEPTH];
+	int cnt = backtrace(buf, TRACE_SKIP + TRACE_DEPTH) - TRACE_SKIP;
+	if (cnt <= 0) {
+		return 0;
+	}
+
+	mem_copy(frames, TRACE_DEPTH * sizeof(void *), &buf[TRACE_SKIP], cnt * sizeof(void *));
+	return cnt;
+#else
+	(void)frames;
+	return 0;
+#endif
+}
+
+static uint hash_ptr(const void *ptr, uint cap)
+{
+	u64 hash = (u64)(size_t)ptr >> 4;
+	hash *= 0x9e3779b97f4a7c15;
+	return (uint)(hash >> 32) & (cap - 1);
+}
+
+static uint site_get(trace_t *trace, const char *tag)
+{
+	for (uint i = 0; i < trace->sites_cnt; i++) {
+		if (trace->sites[i].tag == tag) {
+			return i;
+		}
+	}
+
+	if (trace->sites_cnt >= trace->sites_cap) {
+		uint cap = trace->sites_cap == 0 ? 4 : trace->sites_cap * 2;
+
+		trace_site_t *sites;
+		if (trace->sites == NULL) {
+			sites = mem_alloc(cap * sizeof(trace_site_t));
+		} else {
+			sites = mem_realloc(trace->sites, cap * sizeof(trace_site_t), trace->sites_cap * sizeof(trace_site_t));
+		}
+
+		if (sites == NULL) {
+			log_error("cutils", "trace", NULL, "failed to add site");
+			return (uint)-1;
+		}
+
+		trace->sites	 = sites;
+		trace->sites_cap = cap;
+	}
+
+	trace->sites[trace->sites_cnt] = (trace_site_t){.tag = tag};
+
+	return trace->sites_cnt++;
+}
+
+trace_t *trace_init(trace_t *trace, alloc_t alloc, int backtrace)
+{
+	if (trace == NULL) {
+		return NULL;
+	}
+
+	trace->alloc	 = alloc;
+	trace->entries	 = NULL;
+	trace->frames	 = NULL;
+	trace->cap	 = 0;
+	trace->cnt	 = 0;
+	trace->sites	 = NULL;
+	trace->sites_cap = 0;
+	trace->sites_cnt = 0;
+	trace->site	 = 0;
+	trace->backtrace = backtrace;
+
+	if (site_get(trace, NULL) == (uint)-1) {
+		return NULL;
+	}
+
+	return trace;
+}
+
+void trace_free(trace_t *trace)
+{
+	if (trace == NULL) {
+		return;
+	}
+
+	if (trace->entries) {
+		mem_free(trace->entries, trace->cap * sizeof(trace_entry_t));
+	}
+	if (trace->frames) {
+		mem_free(trace->frames, trace->cap * TRACE_DEPTH * sizeof(void *));
+	}
+	if (trace->sites) {
+		mem_free(trace->sites, trace->sites_cap * sizeof(trace_site_t));
+	}
+
+	trace->entries	 = NULL;
+	trace->frames	 = NULL;
+	trace->cap	 = 0;
+	trace->cnt	 = 0;
+	trace->sites	 = NULL;
+	trace->sites_cap = 0;
+	trace->sites_cnt = 0;
+	trace->site	 = 0;
+}
+
+const char *trace_tag(trace_t *trace, const char *tag)
+{
+	if (trace == NULL || trace->sites == NULL) {
+		return NULL;
+	}
+
+	const char *prev = trace->sites[trace->site].tag;
+
+	uint site = site_get(trace, tag);
+	if (site != (uint)-1) {
+		trace->site = site;
+	}
+
+	return prev;
+}
+
+static void entry_set(trace_t *trace, uint dst, const trace_entry_t *entry, void *const *frames)
+{
+	trace->entries[dst] = *entry;
+	if (trace->frames && frames) {
+		mem_copy(&trace->frames[dst * TRACE_DEPTH], TRACE_DEPTH * sizeof(void *), frames, TRACE_DEPTH * sizeof(void *));
+	}
+}
+
+static uint entry_find(const trace_t *trace, const void *ptr)
+{
+	if (trace->cap == 0) {
+		return (uint)-1;
+	}
+
+	uint index = hash_ptr(ptr, trace->cap);
+	while (trace->entries[index].ptr != NULL) {
+		if (trace->entries[index].ptr == ptr) {
+			return index;
+		}
+		index = (index + 1) & (trace->cap - 1);
+	}
+
+	return (uint)-1;
+}
+
+static uint entry_slot(const trace_t *trace, const void *ptr)
+{
+	uint index = hash_ptr(ptr, trace->cap);
+	while (trace->entries[index].ptr != NULL) {
+		index = (index + 1) & (trace->cap - 1);
+	}
+
+	return index;
+}
+
+static int entries_resize(trace_t *trace)
+{
+	uint cap = trace->cap == 0 ? TRACE_MIN_CAP : trace->cap * 2;
+
+	trace_entry_t *entries = mem_calloc(cap, sizeof(trace_entry_t));
+	if (entries == NULL) {
+		return 1;
+	}
+
+	void **frames = NULL;
+	if (trace->backtrace) {
+		frames = mem_calloc(cap * TRACE_DEPTH, sizeof(void *));
+		if (frames == NULL) {
+			mem_free(entries, cap * sizeof(trace_entry_t));
+			return 1;
+		}
+	}
+
+	trace_t old = *trace;
+
+	trace->entries = entries;
+	trace->frames  = frames;
+	trace->cap     = cap;
+
+	for (uint i = 0; i < old.cap; i++) {
+		if (old.entries[i].ptr != NULL) {
+			entry_set(trace, entry_slot(trace, old.entries[i].ptr), &old.entries[i], old.frames ? &old.frames[i * TRACE_DEPTH] : NULL);
+		}
+	}
+
+	if (old.entries) {
+		mem_free(old.entries, old.cap * sizeof(trace_entry_t));
+	}
+	if (old.frames) {
+		mem_free(old.frames, old.cap * TRACE_DEPTH * sizeof(void *));
+	}
+
+	return 0;
+}
+
+static void entry_add(trace_t *trace, void *ptr, size_t size, uint site, void *const *frames)
+{
+	if ((trace->cnt + 1) * 4 > trace->cap * 3 && entries_resize(trace)) {
+		log_error("cutils", "trace", NULL, "failed to track allocation");
+		return;
+	}
+
+	trace_entry_t entry = {.ptr = ptr, .size = size, .site = site};
+	entry_set(trace, entry_slot(trace, ptr), &entry, frames);
+	trace->cnt++;
+
+	trace->sites[site].live += size;
+	trace->sites[site].cnt++;
+}
+
+static void entry_remove(trace_t *trace, uint index)
+{
+	trace_entry_t *entry = &trace->entries[index];
+	trace_site_t *site   = &trace->sites[entry->site];
+	site->live -= entry->size;
+	site->cnt--;
+
+	uint mask = trace->cap - 1;
+	uint hole = index;
+	for (uint cur = (hole + 1) & mask; trace->entries[cur].ptr != NULL; cur = (cur + 1) & mask) {
+		uint home = hash_ptr(trace->entries[cur].ptr, trace->cap);
+		if (((cur - home) & mask) >= ((cur - hole) & mask)) {
+			entry_set(trace, hole, &trace->entries[cur], trace->frames ? &trace->frames[cur * TRACE_DEPTH] : NULL);
+			hole = cur;
+		}
+	}
+
+	trace->entries[hole].ptr = NULL;
+	trace->cnt--;
+}
+
+void *alloc_alloc_trace(alloc_t *alloc, size_t size)
+{
+	trace_t *trace = alloc->priv;
+	if (trace == NULL || trace->sites == NULL) {
+		return NULL;
+	}
+
+	void *ptr = alloc_alloc(&trace->alloc, size);
+	if (ptr == NULL) {
+		return NULL;
+	}
+
+	trace_site_t *site = &trace->sites[trace->site];
+	site->calls++;
+	site->bytes += size;
+
+	void *frames[TRACE_DEPTH] = {0};
+	if (trace->backtrace) {
+		capture(frames);
+	}
+
+	entry_add(trace, ptr, size, trace->site, frames);
+
+	return ptr;
+}
+
+int alloc_realloc_trace(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size)
+{
+	trace_t *trace = alloc->priv;
+	if (trace == NULL || trace->sites == NULL) {
+		return 1;
+	}
+
+	void *old_ptr  = *ptr;
+	size_t old_len = *old_size;
+	if (alloc_realloc(&trace->alloc, ptr, old_size, new_size)) {
+		return 1;
+	}
+
+	void *frames[TRACE_DEPTH] = {0};
+
+	uint site  = trace->site;
+	uint index = entry_find(trace, old_ptr);
+	if (index != (uint)-1) {
+		site = trace->entries[index].site;
+		if (trace->frames) {
+			mem_copy(frames, sizeof(frames), &trace->frames[index * TRACE_DEPTH], sizeof(frames));
+		}
+		entry_remove(trace, index);
+	} else if (trace->backtrace) {
+		capture(frames);
+	}
+
+	trace->sites[site].calls++;
+	if (new_size > old_len) {
+		trace->sites[site].bytes += new_size - old_len;
+	}
+
+	entry_add(trace, *ptr, new_size, site, frames);
+
+	return 0;
+}
+
+void alloc_free_trace(alloc_t *alloc, void *ptr, size_t size)
+{
+	trace_t *trace = alloc->priv;
+	if (trace == NULL || ptr == NULL) {
+		return;
+	}
+
+	uint index = entry_find(trace, ptr);
+	if (index != (uint)-1) {
+		entry_remove(trace, index);
+	}
+
+	alloc_free(&trace->alloc, ptr, size);
+}
+
+static size_t site_key(const trace_site_t *site, int by)
+{
+	switch (by) {
+	case TRACE_BY_BYTES: return site->bytes;
+	case TRACE_BY_CALLS: return site->calls;
+	default: return site->live;
+	}
+}
+
+size_t trace_print(const trace_t *trace, int by, uint n, dst_t dst)
+{
+	if (trace == NULL) {
+		return 0;
+	}
+
+	size_t off = dst.off;
+
+	uint printed = 0;
+	size_t last  = (size_t)-1;
+	uint last_i  = 0;
+	while (printed < n) {
+		uint best = (uint)-1;
+		for (uint i = 0; i < trace->sites_cnt; i++) {
+			size_t key = site_key(&trace->sites[i], by);
+			if (key > last || (key == last && i <= last_i) || key == 0) {
+				continue;
+			}
+
+			if (best == (uint)-1 || key > site_key(&trace->sites[best], by)) {
+				best = i;
+			}
+		}
+
+		if (best == (uint)-1) {
+			break;
+		}
+
+		const trace_site_t *site = &trace->sites[best];
+		dst.off += dputf(dst,
+				 "%-16s live: %zu B (%zu)  bytes: %zu B  calls: %zu\n",
+				 site->tag ? site->tag : "(none)",
+				 site->live,
+				 site->cnt,
+				 site->bytes,
+				 site->calls);
+
+		last   = site_key(site, by);
+		last_i = best;
+		printed++;
+	}
+
+	return dst.off - off;
+}
+
+size_t trace_print_live(const trace_t *trace, uint n, dst_t dst)
+{
+	if (trace == NULL) {
+		return 0;
+	}
+
+	size_t off = dst.off;
+
+	uint printed = 0;
+	size_t last  = (size_t)-1;
+	uint last_i  = 0;
+	while (printed < n) {
+		uint best = (uint)-1;
+		for (uint i = 0; i < trace->cap; i++) {
+			const trace_entry_t *entry = &trace->entries[i];
+			if (entry->ptr == NULL || entry->size > last || (entry->size == last && i <= last_i)) {
+				continue;
+			}
+
+			if (best == (uint)-1 || entry->size > trace->entries[best].size) {
+				best = i;
+			}
+		}
+
+		if (best == (uint)-1) {
+			break;
+		}
+
+		const trace_entry_t *entry = &trace->entries[best];
+		const trace_site_t *site   = &trace->sites[entry->site];
+		dst.off += dputf(dst, "%p %zu B %s\n", entry->ptr, entry->size, site->tag ? site->tag : "(none)");
+
+		for (int i = 0; trace->frames && i < TRACE_DEPTH && trace->frames[best * TRACE_DEPTH + i]; i++) {
+			dst.off += dputf(dst, "    #%d %p\n", i, trace->frames[best * TRACE_DEPTH + i]);
+		}
+
+		last   = entry->size;
+		last_i = best;
+		printed++;
+	}
+
+	return dst.off - off;
+}
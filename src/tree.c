@@ -4,6 +4,9 @@
 #include "mem.h"
 
 typedef struct header_s {
+	tree_node_t parent;
+	tree_node_t last;
+	uint size;
 	tree_node_t child;
 } header_t;
 
@@ -23,8 +26,8 @@ void tree_reset(tree_t *tree, uint cnt)
 		return;
 	}
 
-	if (cnt > tree->cnt) {
-		cnt = tree->cnt;
+	if (cnt > tree->nodes.cnt) {
+		cnt = tree->nodes.cnt;
 	}
 
 	list_reset(tree, cnt);
@@ -33,9 +36,24 @@ void tree_reset(tree_t *tree, uint cnt)
 	tree_foreach_all(tree, node)
 	{
 		header_t *header = list_get(tree, node);
+		if (header->parent >= cnt) {
+			header->parent = (tree_node_t)-1;
+		}
+
 		if (header->child >= cnt) {
 			header->child = (tree_node_t)-1;
 		}
+
+		if (node + header->size > cnt) {
+			header->size = 0;
+		}
+
+		tree_node_t next = header->child;
+		header->last	 = next;
+		while (next < cnt) {
+			header->last = next;
+			tree_get_next(tree, next, &next);
+		}
 	}
 }
 
@@ -51,11 +69,27 @@ void *tree_node(tree_t *tree, tree_node_t *node)
 		return NULL;
 	}
 
-	header->child = (tree_node_t)-1;
+	header->parent = (tree_node_t)-1;
+	header->last   = (tree_node_t)-1;
+	header->size   = 0;
+	header->child  = (tree_node_t)-1;
 
 	return header + 1;
 }
 
+static void unfreeze(tree_t *tree, tree_node_t node)
+{
+	while (node < tree->nodes.cnt) {
+		header_t *header = list_get(tree, node);
+		if (header->size == 0) {
+			break;
+		}
+
+		header->size = 0;
+		node	     = header->parent;
+	}
+}
+
 int tree_add(tree_t *tree, tree_node_t node, tree_node_t child)
 {
 	if (tree == NULL) {
@@ -68,17 +102,41 @@ int tree_add(tree_t *tree, tree_node_t node, tree_node_t child)
 		return 1;
 	}
 
-	if (list_get(tree, child) == NULL) {
+	header_t *child_header = list_get(tree, child);
+	if (child_header == NULL) {
 		log_error("cutils", "tree", NULL, "invalid node: %d", child);
 		return 1;
 	}
 
+	if (child_header->parent != (tree_node_t)-1) {
+		log_error("cutils", "tree", NULL, "node already has a parent: %d", child);
+		return 1;
+	}
+
+	for (tree_node_t cur = child; cur < tree->nodes.cnt; tree_get_next(tree, cur, &cur)) {
+		if (tree_is_ancestor(tree, cur, node)) {
+			log_error("cutils", "tree", NULL, "append will create a loop: %d", cur);
+			return 1;
+		}
+	}
+
+	unfreeze(tree, node);
+
 	if (header->child == (tree_node_t)-1) {
 		header->child = child;
-		return 0;
+	} else if (list_set_next(tree, header->last, child)) {
+		return 1;
+	}
+
+	tree_node_t cur = child;
+	while (cur < tree->nodes.cnt) {
+		child_header	     = list_get(tree, cur);
+		child_header->parent = node;
+		header->last	     = cur;
+		tree_get_next(tree, cur, &cur);
 	}
 
-	return list_app(tree, header->child, child);
+	return 0;
 }
 
 int tree_app(tree_t *tree, tree_node_t node, tree_node_t next)
@@ -87,6 +145,17 @@ int tree_app(tree_t *tree, tree_node_t node, tree_node_t next)
 		return 1;
 	}
 
+	header_t *header = list_get(tree, node);
+	if (header != NULL && header->parent != (tree_node_t)-1) {
+		return tree_add(tree, header->parent, next);
+	}
+
+	header_t *next_header = list_get(tree, next);
+	if (next_header != NULL && next_header->parent != (tree_node_t)-1) {
+		log_error("cutils", "tree", NULL, "node already has a parent: %d", next);
+		return 1;
+	}
+
 	if (list_app(tree, node, next)) {
 		log_error("cutils", "tree", NULL, "failed to append");
 		return 1;
@@ -101,14 +170,139 @@ int tree_remove(tree_t *tree, tree_node_t node)
 		return 1;
 	}
 
-	for (uint i = 0; i < tree->cnt; i++) {
-		header_t *data = list_get(tree, i);
-		if (data->child == node) {
-			list_get_next(tree, node, &data->child);
+	header_t *header = list_get(tree, node);
+	if (header == NULL) {
+		return 1;
+	}
+
+	if (header->parent == (tree_node_t)-1) {
+		if (list_remove(tree, node)) {
+			return 1;
+		}
+
+		list_set_next(tree, node, (tree_node_t)-1);
+		return 0;
+	}
+
+	unfreeze(tree, header->parent);
+
+	header_t *parent = list_get(tree, header->parent);
+
+	tree_node_t next;
+	tree_get_next(tree, node, &next);
+
+	tree_node_t prev = (tree_node_t)-1;
+	if (parent->child == node) {
+		parent->child = next;
+	} else {
+		prev = parent->child;
+		tree_node_t cur;
+		while (tree_get_next(tree, prev, &cur) != NULL && cur != node) {
+			prev = cur;
+		}
+
+		list_set_next(tree, prev, next);
+	}
+
+	if (parent->last == node) {
+		parent->last = prev;
+	}
+
+	header->parent = (tree_node_t)-1;
+	list_set_next(tree, node, (tree_node_t)-1);
+
+	return 0;
+}
+
+int tree_move(tree_t *tree, tree_node_t node, tree_node_t parent)
+{
+	if (tree == NULL) {
+		return 1;
+	}
+
+	if (list_get(tree, parent) == NULL || tree_is_ancestor(tree, node, parent)) {
+		log_error("cutils", "tree", NULL, "invalid parent: %d", parent);
+		return 1;
+	}
+
+	if (tree_remove(tree, node)) {
+		return 1;
+	}
+
+	return tree_add(tree, parent, node);
+}
+
+static void release_subtree(tree_t *tree, tree_node_t node)
+{
+	header_t *header = list_get(tree, node);
+
+	tree_node_t child = header->child;
+	while (child < tree->nodes.cnt) {
+		tree_node_t next;
+		tree_get_next(tree, child, &next);
+		release_subtree(tree, child);
+		child = next;
+	}
+
+	list_release(tree, node);
+}
+
+int tree_delete(tree_t *tree, tree_node_t node)
+{
+	if (tree_remove(tree, node)) {
+		return 1;
+	}
+
+	release_subtree(tree, node);
+
+	return 0;
+}
+
+int tree_compact(tree_t *tree, tree_node_t *remap)
+{
+	if (tree == NULL) {
+		return 1;
+	}
+
+	uint cnt = tree->nodes.cnt;
+	if (cnt == 0) {
+		return 0;
+	}
+
+	tree_node_t *ids = remap;
+	if (ids == NULL) {
+		ids = alloc_alloc(&tree->nodes.alloc, cnt * sizeof(tree_node_t));
+		if (ids == NULL) {
+			log_error("cutils", "tree", NULL, "failed to allocate remap table");
+			return 1;
+		}
+	}
+
+	int ret = list_compact(tree, ids);
+	if (ret == 0) {
+		tree_node_t node = 0;
+		tree_foreach_all(tree, node)
+		{
+			header_t *header = list_get(tree, node);
+			if (header->parent < cnt) {
+				header->parent = ids[header->parent];
+			}
+
+			if (header->last < cnt) {
+				header->last = ids[header->last];
+			}
+
+			if (header->child < cnt) {
+				header->child = ids[header->child];
+			}
 		}
 	}
 
-	return list_remove(tree, node);
+	if (remap == NULL) {
+		alloc_free(&tree->nodes.alloc, ids, cnt * sizeof(tree_node_t));
+	}
+
+	return ret;
 }
 
 void *tree_get(const tree_t *tree, tree_node_t node)
@@ -155,6 +349,191 @@ void *tree_get_next(const tree_t *tree, tree_node_t node, tree_node_t *next)
 	return header == NULL ? NULL : header + 1;
 }
 
+void *tree_get_parent(const tree_t *tree, tree_node_t node, tree_node_t *parent)
+{
+	if (tree == NULL) {
+		return NULL;
+	}
+
+	header_t *header = list_get(tree, node);
+	if (header == NULL) {
+		log_error("cutils", "tree", NULL, "invalid node: %d", node);
+		return NULL;
+	}
+
+	if (parent) {
+		*parent = header->parent;
+	}
+
+	if (header->parent == (tree_node_t)-1) {
+		return NULL;
+	}
+
+	return tree_get(tree, header->parent);
+}
+
+int tree_depth(const tree_t *tree, tree_node_t node)
+{
+	if (tree == NULL || list_get(tree, node) == NULL) {
+		return -1;
+	}
+
+	int depth = 0;
+	while (tree_get_parent(tree, node, &node) != NULL) {
+		depth++;
+	}
+
+	return depth;
+}
+
+uint tree_path(const tree_t *tree, tree_node_t node, tree_node_t *path, uint cap)
+{
+	int depth = tree_depth(tree, node);
+	if (depth < 0 || path == NULL || (uint)depth >= cap) {
+		return 0;
+	}
+
+	uint cnt = (uint)depth + 1;
+	for (uint i = cnt; i > 0; i--) {
+		path[i - 1] = node;
+		tree_get_parent(tree, node, &node);
+	}
+
+	return cnt;
+}
+
+int tree_is_ancestor(const tree_t *tree, tree_node_t node, tree_node_t of)
+{
+	if (tree == NULL) {
+		return 0;
+	}
+
+	header_t *header = list_get(tree, node);
+	if (header == NULL || list_get(tree, of) == NULL) {
+		return 0;
+	}
+
+	if (header->size > 0) {
+		return of >= node && of - node < header->size;
+	}
+
+	for (tree_node_t cur = of; cur < tree->nodes.cnt; cur = ((header_t *)list_get(tree, cur))->parent) {
+		if (cur == node) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+uint tree_size(const tree_t *tree, tree_node_t node)
+{
+	if (tree == NULL) {
+		return 0;
+	}
+
+	header_t *header = list_get(tree, node);
+	if (header == NULL) {
+		return 0;
+	}
+
+	if (header->size > 0) {
+		return header->size;
+	}
+
+	uint size = 1;
+	tree_node_t child;
+	if (tree_get_child(tree, node, &child) != NULL) {
+		do {
+			size += tree_size(tree, child);
+		} while (tree_get_next(tree, child, &child) != NULL);
+	}
+
+	return size;
+}
+
+static tree_node_t next_pre(const tree_t *tree, tree_node_t root, tree_node_t node)
+{
+	tree_node_t next;
+	if (tree_get_child(tree, node, &next) != NULL) {
+		return next;
+	}
+
+	while (node != root) {
+		header_t *header = list_get(tree, node);
+		if (tree_get_next(tree, node, &next) != NULL) {
+			return next;
+		}
+
+		node = header->parent;
+	}
+
+	return (tree_node_t)-1;
+}
+
+int tree_freeze(tree_t *tree, tree_node_t *remap)
+{
+	if (tree == NULL) {
+		return 1;
+	}
+
+	uint cnt = tree->nodes.cnt;
+	if (cnt == 0) {
+		return 0;
+	}
+
+	tree_node_t *ids = remap;
+	if (ids == NULL) {
+		ids = alloc_alloc(&tree->nodes.alloc, cnt * sizeof(tree_node_t));
+		if (ids == NULL) {
+			log_error("cutils", "tree", NULL, "failed to allocate remap table");
+			return 1;
+		}
+	}
+
+	for (uint i = 0; i < cnt; i++) {
+		ids[i] = (tree_node_t)-1;
+	}
+
+	uint used	 = 0;
+	tree_node_t root = 0;
+	tree_foreach_all(tree, root)
+	{
+		header_t *header = list_get(tree, root);
+		if (header->parent != (tree_node_t)-1) {
+			continue;
+		}
+
+		for (tree_node_t node = root; node < cnt; node = next_pre(tree, root, node)) {
+			ids[node] = used++;
+		}
+	}
+
+	int ret = list_remap(tree, ids);
+	if (ret == 0) {
+		for (uint i = 0; i < used; i++) {
+			header_t *header = list_get(tree, i);
+			header->parent	 = header->parent < cnt ? ids[header->parent] : header->parent;
+			header->last	 = header->last < cnt ? ids[header->last] : header->last;
+			header->child	 = header->child < cnt ? ids[header->child] : header->child;
+			header->size	 = 1;
+		}
+
+		for (uint i = used; i > 0; i--) {
+			header_t *header = list_get(tree, i - 1);
+			if (header->parent != (tree_node_t)-1) {
+				((header_t *)list_get(tree, header->parent))->size += header->size;
+			}
+		}
+	}
+
+	if (remap == NULL) {
+		alloc_free(&tree->nodes.alloc, ids, cnt * sizeof(tree_node_t));
+	}
+
+	return ret;
+}
+
 static int node_iterate_pre(const tree_t *tree, tree_node_t node, tree_iterate_cb cb, int ret, void *priv, int depth, int last)
 {
 	void *data = tree_get(tree, node);
@@ -172,9 +551,9 @@ static int node_iterate_pre(const tree_t *tree, tree_node_t node, tree_iterate_c
 	}
 
 	tree_node_t next;
-	while (child < tree->cnt) {
+	while (child < tree->nodes.cnt) {
 		tree_get_next(tree, child, &next);
-		ret   = node_iterate_pre(tree, child, cb, ret, priv, depth + 1, last | ((next >= tree->cnt) << depth));
+		ret   = node_iterate_pre(tree, child, cb, ret, priv, depth + 1, last | ((next >= tree->nodes.cnt) << depth));
 		child = next;
 	}
 
@@ -194,9 +573,9 @@ int tree_iterate_childs(const tree_t *tree, tree_node_t node, tree_iterate_child
 	}
 
 	tree_node_t next;
-	while (child < tree->cnt) {
+	while (child < tree->nodes.cnt) {
 		tree_get_next(tree, child, &next);
-		ret   = cb(tree, child, tree_get(tree, child), ret, next >= tree->cnt, priv);
+		ret   = cb(tree, child, tree_get(tree, child), ret, next >= tree->nodes.cnt, priv);
 		child = next;
 	}
 
@@ -217,12 +596,12 @@ size_t tree_print(const tree_t *tree, tree_node_t node, tree_print_cb cb, dst_t
 		tree_node_t next;
 		for (int i = 0; i < depth - 1; i++) {
 			tree_get_next(tree, _it.stack[i + 1], &next);
-			dst.off += dputs(dst, next < tree->cnt ? STRV("│ ") : STRV("  "));
+			dst.off += dputs(dst, next < tree->nodes.cnt ? STRV("│ ") : STRV("  "));
 		}
 
 		if (depth > 0) {
 			tree_get_next(tree, _it.stack[depth], &next);
-			dst.off += dputs(dst, next < tree->cnt ? STRV("├─") : STRV("└─"));
+			dst.off += dputs(dst, next < tree->nodes.cnt ? STRV("├─") : STRV("└─"));
 		}
 
 		dst.off += cb(tree_get(tree, cur), dst, priv);
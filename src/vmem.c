@@ -0,0 +1,237 @@
+#include "vmem.h"
+
+#include "log.h"
+#include "mem.h"
+#include "platform.h"
+#include "type.h"
+
+#if defined(C_WIN)
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+#define VMEM_ALIGN     (2 * sizeof(void *))
+#define VMEM_HUGE_PAGE (2 * 1024 * 1024)
+
+#define ALIGN(_size, _align) (((_size) + (_align) - 1) & ~((_align) - 1))
+
+static size_t page_size()
+{
+#if defined(C_WIN)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+#else
+	return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+static void *vm_reserve(size_t size, int *flags)
+{
+#if defined(C_WIN)
+	*flags &= ~VMEM_HUGETLB;
+	return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	#if defined(MAP_HUGETLB)
+	if (*flags & VMEM_HUGETLB) {
+		// no MAP_NORESERVE: an empty huge page pool fails here instead of faulting on first write
+		void *base = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (base != MAP_FAILED) {
+			return base;
+		}
+		log_warn("cutils", "vmem", NULL, "huge pages unavailable, falling back to transparent huge pages");
+	}
+	#endif
+	if (*flags & VMEM_HUGETLB) {
+		*flags = (*flags & ~VMEM_HUGETLB) | VMEM_THP;
+	}
+
+	size_t pad = *flags & VMEM_THP ? VMEM_HUGE_PAGE : 0;
+
+	byte *base = mmap(NULL, size + pad, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (base == MAP_FAILED) {
+		return NULL;
+	}
+
+	if (pad) {
+		size_t head = ALIGN((size_t)base, VMEM_HUGE_PAGE) - (size_t)base;
+		if (head) {
+			munmap(base, head);
+		}
+		if (pad - head) {
+			munmap(base + head + size, pad - head);
+		}
+		base += head;
+	}
+
+	#if defined(MADV_HUGEPAGE)
+	if (*flags & VMEM_THP) {
+		madvise(base, size, MADV_HUGEPAGE);
+	}
+	#endif
+	return base;
+#endif
+}
+
+static int vm_commit(void *addr, size_t size)
+{
+#if defined(C_WIN)
+	return VirtualAlloc(addr, size, MEM_COMMIT, PAGE_READWRITE) == NULL;
+#else
+	return mprotect(addr, size, PROT_READ | PROT_WRITE) != 0;
+#endif
+}
+
+static void vm_release(void *addr, size_t size)
+{
+#if defined(C_WIN)
+	(void)size;
+	VirtualFree(addr, 0, MEM_RELEASE);
+#else
+	munmap(addr, size);
+#endif
+}
+
+vmem_t *vmem_init(vmem_t *vmem, size_t reserve, int flags)
+{
+	if (vmem == NULL) {
+		return NULL;
+	}
+
+	size_t page = flags & (VMEM_THP | VMEM_HUGETLB) ? VMEM_HUGE_PAGE : page_size();
+	reserve	    = ALIGN(reserve, page);
+
+	void *base = vm_reserve(reserve, &flags);
+	if (base == NULL) {
+		log_error("cutils", "vmem", NULL, "failed to reserve %zu bytes", reserve);
+		return NULL;
+	}
+
+	vmem->base	= base;
+	vmem->reserved	= reserve;
+	vmem->committed = 0;
+	vmem->used	= 0;
+	vmem->last	= 0;
+	vmem->page	= page;
+	vmem->flags	= flags;
+
+	return vmem;
+}
+
+void vmem_free(vmem_t *vmem)
+{
+	if (vmem == NULL || vmem->base == NULL) {
+		return;
+	}
+
+	vm_release(vmem->base, vmem->reserved);
+
+	vmem->base	= NULL;
+	vmem->reserved	= 0;
+	vmem->committed = 0;
+	vmem->used	= 0;
+	vmem->last	= 0;
+}
+
+void vmem_reset(vmem_t *vmem)
+{
+	if (vmem == NULL) {
+		return;
+	}
+
+	vmem->used = 0;
+	vmem->last = 0;
+}
+
+static int vmem_commit(vmem_t *vmem, size_t used)
+{
+	if (used > vmem->reserved) {
+		log_error("cutils", "vmem", NULL, "reserved range exhausted: %zu/%zu", used, vmem->reserved);
+		return 1;
+	}
+
+	if (used <= vmem->committed) {
+		return 0;
+	}
+
+	size_t committed = ALIGN(used, vmem->page);
+	if (committed > vmem->reserved) {
+		committed = vmem->reserved;
+	}
+
+	if (vm_commit((byte *)vmem->base + vmem->committed, committed - vmem->committed)) {
+		log_error("cutils", "vmem", NULL, "failed to commit %zu bytes", committed - vmem->committed);
+		return 1;
+	}
+
+	vmem->committed = committed;
+
+	return 0;
+}
+
+void *alloc_alloc_vmem(alloc_t *alloc, size_t size)
+{
+	vmem_t *vmem = alloc->priv;
+	if (vmem == NULL || vmem->base == NULL) {
+		return NULL;
+	}
+
+	size_t start = ALIGN(vmem->used, VMEM_ALIGN);
+	if (size > vmem->reserved - start || vmem_commit(vmem, start + size)) {
+		return NULL;
+	}
+
+	vmem->last = start;
+	vmem->used = start + size;
+
+	return (byte *)vmem->base + start;
+}
+
+int alloc_realloc_vmem(alloc_t *alloc, void **ptr, size_t *old_size, size_t new_size)
+{
+	vmem_t *vmem = alloc->priv;
+	if (vmem == NULL || vmem->base == NULL) {
+		return 1;
+	}
+
+	if (*ptr == (byte *)vmem->base + vmem->last && vmem->last + *old_size == vmem->used) {
+		if (new_size > vmem->reserved - vmem->last || vmem_commit(vmem, vmem->last + new_size)) {
+			return 1;
+		}
+
+		vmem->used = vmem->last + new_size;
+		*old_size  = new_size;
+		return 0;
+	}
+
+	if (new_size <= *old_size) {
+		*old_size = new_size;
+		return 0;
+	}
+
+	void *data = alloc_alloc_vmem(alloc, new_size);
+	if (data == NULL) {
+		return 1;
+	}
+
+	mem_copy(data, new_size, *ptr, *old_size);
+
+	*ptr	  = data;
+	*old_size = new_size;
+
+	return 0;
+}
+
+void alloc_free_vmem(alloc_t *alloc, void *ptr, size_t size)
+{
+	vmem_t *vmem = alloc->priv;
+	if (vmem == NULL || vmem->base == NULL || ptr == NULL) {
+		return;
+	}
+
+	if (ptr == (byte *)vmem->base + vmem->last && vmem->last + size == vmem->used) {
+		vmem->used = vmem->last;
+	}
+}
@@ -3,53 +3,75 @@
 #include "test.h"
 
 STEST(alloc);
+STEST(arena);
 STEST(args);
 STEST(arr);
 STEST(buf);
 STEST(cbuf);
+STEST(cmap);
 STEST(dict);
+STEST(dlist);
 STEST(fs);
+STEST(hash);
+STEST(hmap);
 STEST(list);
 STEST(loc);
 STEST(log);
 STEST(mem);
+STEST(odict);
 STEST(path);
 STEST(proc);
 STEST(schema);
+STEST(slab);
+STEST(soa);
 STEST(sock);
 STEST(str);
 STEST(strbuf);
 STEST(strv);
 STEST(strvbuf);
+STEST(sync);
 STEST(tbl);
+STEST(trace);
 STEST(tree);
 STEST(type);
+STEST(vmem);
 
 TEST(cutils)
 {
 	SSTART;
 	RUN(alloc);
+	RUN(arena);
 	RUN(args);
 	RUN(arr);
 	RUN(buf);
 	RUN(cbuf);
+	RUN(cmap);
 	RUN(dict);
+	RUN(dlist);
 	RUN(fs);
+	RUN(hash);
+	RUN(hmap);
 	RUN(list);
 	RUN(loc);
 	RUN(log);
 	RUN(mem);
+	RUN(odict);
 	RUN(path);
 	RUN(proc);
 	RUN(schema);
+	RUN(slab);
+	RUN(soa);
 	RUN(sock);
 	RUN(str);
 	RUN(strbuf);
 	RUN(strv);
 	RUN(strvbuf);
+	RUN(sync);
 	RUN(tbl);
+	RUN(trace);
 	RUN(tree);
 	RUN(type);
+	RUN(vmem);
 	SEND;
 }
 
@@ -1,5 +1,8 @@
 #include "alloc.h"
 
+#include "arena.h"
+#include "log.h"
+#include "mem.h"
 #include "test.h"
 
 TEST(alloc_alloc)
@@ -45,6 +48,117 @@ TEST(alloc_free)
 	END;
 }
 
+TEST(alloc_alloc_aligned)
+{
+	START;
+
+	alloc_t alloc = ALLOC_STD;
+
+	void *mem = alloc_alloc_aligned(&alloc, 1, 0);
+	EXPECT_NOT_NULL(mem);
+	alloc_free_aligned(&alloc, mem, 1, 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_NULL(alloc_alloc_aligned(&alloc, 1, 3));
+	log_set_quiet(0, 0);
+
+	mem_oom(1);
+	EXPECT_NULL(alloc_alloc_aligned(&alloc, 1, 64));
+	mem_oom(0);
+
+	mem = alloc_alloc_aligned(&alloc, 1, 64);
+	EXPECT_EQ((size_t)mem & 63, 0);
+	alloc_free_aligned(&alloc, mem, 1, 64);
+
+	mem = alloc_alloc_aligned(&alloc, 1, 1);
+	EXPECT_EQ((size_t)mem & (sizeof(size_t) - 1), 0);
+	alloc_free_aligned(&alloc, mem, 1, 1);
+
+	alloc_free_aligned(&alloc, NULL, 0, 64);
+
+	END;
+}
+
+TEST(alloc_realloc_aligned)
+{
+	START;
+
+	alloc_t alloc = ALLOC_STD;
+
+	size_t size = 1;
+	void *mem   = alloc_alloc_aligned(&alloc, size, 0);
+
+	EXPECT_EQ(alloc_realloc_aligned(&alloc, &mem, &size, 2, 0), 0);
+	EXPECT_EQ(size, 2);
+	alloc_free_aligned(&alloc, mem, size, 0);
+
+	size = 0;
+	mem  = NULL;
+	mem_oom(1);
+	EXPECT_EQ(alloc_realloc_aligned(&alloc, &mem, &size, 8, 64), 1);
+	mem_oom(0);
+	EXPECT_EQ(alloc_realloc_aligned(&alloc, &mem, &size, 8, 64), 0);
+	EXPECT_EQ(size, 8);
+	EXPECT_EQ((size_t)mem & 63, 0);
+
+	for (int i = 0; i < 8; i++) {
+		((byte *)mem)[i] = (byte)i;
+	}
+
+	mem_oom(1);
+	EXPECT_EQ(alloc_realloc_aligned(&alloc, &mem, &size, 1024, 64), 1);
+	mem_oom(0);
+	EXPECT_EQ(alloc_realloc_aligned(&alloc, &mem, &size, 1024, 64), 0);
+	EXPECT_EQ(size, 1024);
+	EXPECT_EQ((size_t)mem & 63, 0);
+	EXPECT_EQ(((byte *)mem)[7], 7);
+
+	alloc_free_aligned(&alloc, mem, size, 64);
+
+	END;
+}
+
+TEST(alloc_aligned_arena)
+{
+	START;
+
+	arena_t arena = {0};
+	arena_init(&arena, 256, ALLOC_STD);
+
+	alloc_t alloc = ALLOC_ARENA(&arena);
+
+	size_t size = 4;
+	alloc_alloc(&alloc, 8);
+	void *mem = alloc_alloc_aligned(&alloc, size, 64);
+	EXPECT_EQ((size_t)mem & 63, 0);
+	*(int *)mem = 1;
+
+	alloc_alloc(&alloc, 8);
+	EXPECT_EQ(alloc_realloc_aligned(&alloc, &mem, &size, 24, 64), 0);
+	EXPECT_EQ((size_t)mem & 63, 0);
+	EXPECT_EQ(*(int *)mem, 1);
+
+	arena_free(&arena);
+
+	END;
+}
+
+TEST(grow_next)
+{
+	START;
+
+	EXPECT_EQ(grow_next(NULL, 4, 2), 4);
+	EXPECT_EQ(grow_next(NULL, 0, 1), 1);
+	EXPECT_EQ(grow_next(NULL, 4, 5), 8);
+	EXPECT_EQ(grow_next(NULL, 4, 20), 20);
+	EXPECT_EQ(grow_next(&(grow_t){.pct = 150}, 10, 11), 15);
+	EXPECT_EQ(grow_next(&(grow_t){.step = 3}, 10, 11), 13);
+	EXPECT_EQ(grow_next(&(grow_t){.step = 3}, 10, 20), 20);
+	EXPECT_EQ(grow_next(NULL, (size_t)-1 / 2 + 1, (size_t)-1 / 2 + 2), (size_t)-1);
+
+	END;
+}
+
 STEST(alloc)
 {
 	SSTART;
@@ -52,6 +166,10 @@ STEST(alloc)
 	RUN(alloc_alloc);
 	RUN(alloc_realloc);
 	RUN(alloc_free);
+	RUN(alloc_alloc_aligned);
+	RUN(alloc_realloc_aligned);
+	RUN(alloc_aligned_arena);
+	RUN(grow_next);
 
 	SEND;
 }
@@ -0,0 +1,170 @@
+#include "arena.h"
+
+#include "arr.h"
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+TEST(arena_init_free)
+{
+	START;
+
+	arena_t arena = {0};
+
+	EXPECT_NULL(arena_init(NULL, 0, ALLOC_STD));
+	EXPECT_PTR(arena_init(&arena, 64, ALLOC_STD), &arena);
+
+	EXPECT_NULL(arena.first);
+	EXPECT_EQ(arena.block_size, 64);
+
+	arena_free(&arena);
+	arena_free(NULL);
+
+	EXPECT_NULL(arena.first);
+	EXPECT_NULL(arena.cur);
+
+	END;
+}
+
+TEST(arena_alloc)
+{
+	START;
+
+	arena_t arena = {0};
+	arena_init(&arena, 64, ALLOC_STD);
+
+	alloc_t alloc = ALLOC_ARENA(&arena);
+	alloc_t null  = ALLOC_ARENA(NULL);
+
+	EXPECT_NULL(alloc_alloc(&null, 1));
+
+	mem_oom(1);
+	EXPECT_NULL(alloc_alloc(&alloc, 1));
+	mem_oom(0);
+
+	byte *m0 = alloc_alloc(&alloc, 1);
+	byte *m1 = alloc_alloc(&alloc, 1);
+	EXPECT_NOT_NULL(m0);
+	EXPECT_NOT_NULL(m1);
+	EXPECT_EQ(((size_t)m0 & (2 * sizeof(void *) - 1)), 0);
+	EXPECT_EQ(m1 - m0, 2 * sizeof(void *));
+
+	EXPECT_NOT_NULL(alloc_alloc(&alloc, 64));
+	EXPECT_NOT_NULL(alloc_alloc(&alloc, 128));
+
+	alloc_free(&alloc, m0, 1);
+
+	arena_free(&arena);
+
+	END;
+}
+
+TEST(arena_realloc)
+{
+	START;
+
+	arena_t arena = {0};
+	arena_init(&arena, 64, ALLOC_STD);
+
+	alloc_t alloc = ALLOC_ARENA(&arena);
+	alloc_t null  = ALLOC_ARENA(NULL);
+
+	size_t s0 = 4;
+	size_t s1 = 4;
+	void *m0  = alloc_alloc(&alloc, s0);
+	void *m1  = alloc_alloc(&alloc, s1);
+	void *p;
+
+	EXPECT_EQ(alloc_realloc(&null, &m1, &s1, 8), 1);
+
+	p = m1;
+	EXPECT_EQ(alloc_realloc(&alloc, &m1, &s1, 32), 0);
+	EXPECT_PTR(m1, p);
+	EXPECT_EQ(s1, 32);
+
+	p = m0;
+	EXPECT_EQ(alloc_realloc(&alloc, &m0, &s0, 8), 0);
+	EXPECT_PTR(m0, p);
+	EXPECT_EQ(s0, 8);
+
+	*(int *)m0 = 1;
+	EXPECT_EQ(alloc_realloc(&alloc, &m0, &s0, 24), 0);
+	EXPECT_NE(m0, p);
+	EXPECT_EQ(s0, 24);
+	EXPECT_EQ(*(int *)m0, 1);
+
+	mem_oom(1);
+	EXPECT_EQ(alloc_realloc(&alloc, &m0, &s0, 256), 1);
+	mem_oom(0);
+	EXPECT_EQ(s0, 24);
+
+	arena_free(&arena);
+
+	END;
+}
+
+TEST(arena_reset)
+{
+	START;
+
+	arena_t arena = {0};
+	arena_init(&arena, 64, ALLOC_STD);
+
+	alloc_t alloc = ALLOC_ARENA(&arena);
+
+	arena_reset(NULL);
+	arena_reset(&arena);
+
+	void *m0 = alloc_alloc(&alloc, 48);
+	alloc_alloc(&alloc, 48);
+	alloc_alloc(&alloc, 128);
+
+	arena_reset(&arena);
+
+	EXPECT_PTR(alloc_alloc(&alloc, 48), m0);
+	EXPECT_NOT_NULL(alloc_alloc(&alloc, 48));
+	EXPECT_NOT_NULL(alloc_alloc(&alloc, 128));
+	EXPECT_NOT_NULL(alloc_alloc(&alloc, 16));
+
+	arena_free(&arena);
+
+	END;
+}
+
+TEST(arena_arr)
+{
+	START;
+
+	arena_t arena = {0};
+	arena_init(&arena, 256, ALLOC_STD);
+
+	arr_t arr = {0};
+	log_set_quiet(0, 1);
+	arr_init(&arr, 0, sizeof(int), ALLOC_ARENA(&arena));
+	log_set_quiet(0, 0);
+
+	for (int i = 0; i < 32; i++) {
+		*(int *)arr_add(&arr, NULL) = i;
+	}
+
+	EXPECT_EQ(arr.cnt, 32);
+	EXPECT_EQ(*(int *)arr_get(&arr, 31), 31);
+
+	arr_free(&arr);
+	arena_free(&arena);
+
+	END;
+}
+
+STEST(arena)
+{
+	SSTART;
+
+	RUN(arena_init_free);
+	RUN(arena_alloc);
+	RUN(arena_realloc);
+	RUN(arena_reset);
+	RUN(arena_arr);
+
+	SEND;
+}
@@ -32,6 +32,33 @@ TEST(arr_init_free)
 	END;
 }
 
+TEST(arr_init_a)
+{
+	START;
+
+	arr_t arr = {0};
+
+	EXPECT_NULL(arr_init_a(NULL, 0, sizeof(int), 64, ALLOC_STD));
+	mem_oom(1);
+	EXPECT_NULL(arr_init_a(&arr, 1, sizeof(int), 64, ALLOC_STD));
+	mem_oom(0);
+	EXPECT_PTR(arr_init_a(&arr, 1, sizeof(int), 64, ALLOC_STD), &arr);
+
+	EXPECT_EQ((size_t)arr.data & 63, 0);
+	EXPECT_EQ(arr.align, 64);
+
+	for (int i = 0; i < 100; i++) {
+		*(int *)arr_add(&arr, NULL) = i;
+	}
+
+	EXPECT_EQ((size_t)arr.data & 63, 0);
+	EXPECT_EQ(*(int *)arr_get(&arr, 99), 99);
+
+	arr_free(&arr);
+
+	END;
+}
+
 TEST(arr_reset)
 {
 	START;
@@ -77,6 +104,87 @@ TEST(arr_resize)
 	END;
 }
 
+TEST(arr_reserve)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 2, sizeof(int), ALLOC_STD);
+
+	EXPECT_EQ(arr_reserve(NULL, 0), 1);
+	EXPECT_EQ(arr_reserve(&arr, 1), 0);
+	EXPECT_EQ(arr.cap, 2);
+	EXPECT_EQ(arr_reserve(&arr, 3), 0);
+	EXPECT_EQ(arr.cap, 4);
+	EXPECT_EQ(arr_reserve(&arr, 100), 0);
+	EXPECT_EQ(arr.cap, 100);
+
+	arr_set_grow(NULL, (grow_t){0});
+	arr_set_grow(&arr, (grow_t){.exact = 1});
+	EXPECT_EQ(arr_reserve(&arr, 101), 0);
+	EXPECT_EQ(arr.cap, 101);
+	mem_oom(1);
+	EXPECT_EQ(arr_reserve(&arr, 102), 1);
+	mem_oom(0);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_shrink)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 8, sizeof(int), ALLOC_STD);
+
+	EXPECT_EQ(arr_shrink(NULL), 1);
+	EXPECT_EQ(arr_shrink(&arr), 0);
+	EXPECT_EQ(arr.cap, 1);
+
+	arr_reserve(&arr, 8);
+	*(int *)arr_add(&arr, NULL) = 1;
+	*(int *)arr_add(&arr, NULL) = 2;
+	EXPECT_EQ(arr.cap, 8);
+	EXPECT_EQ(arr_shrink(&arr), 0);
+	EXPECT_EQ(arr.cap, 2);
+	EXPECT_EQ(arr_shrink(&arr), 0);
+	EXPECT_EQ(*(int *)arr_get(&arr, 1), 2);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_set_grow)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 10, sizeof(int), ALLOC_STD);
+	arr_set_grow(&arr, (grow_t){.pct = 150, .step = 8});
+
+	for (int i = 0; i < 11; i++) {
+		arr_add(&arr, NULL);
+	}
+	EXPECT_EQ(arr.cap, 15);
+
+	for (int i = 0; i < 5; i++) {
+		arr_add(&arr, NULL);
+	}
+	EXPECT_EQ(arr.cap, 22);
+
+	for (int i = 0; i < 7; i++) {
+		arr_add(&arr, NULL);
+	}
+	EXPECT_EQ(arr.cap, 30);
+
+	arr_free(&arr);
+
+	END;
+}
+
 TEST(arr_add)
 {
 	START;
@@ -279,6 +387,144 @@ TEST(arr_find_cmp)
 	END;
 }
 
+static u64 t_arr_hash_cb(const void *value, size_t size, const void *priv)
+{
+	(void)size;
+	(void)priv;
+	return (u64)(*(const int *)value % 10);
+}
+
+static int t_arr_eq_cb(const void *value1, const void *value2, const void *priv)
+{
+	(void)priv;
+	return *(const int *)value1 % 10 == *(const int *)value2 % 10;
+}
+
+TEST(arr_index)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 4, sizeof(int), ALLOC_STD);
+
+	*(int *)arr_add(&arr, NULL) = 5;
+	*(int *)arr_add(&arr, NULL) = 5;
+
+	EXPECT_EQ(arr_index(NULL, NULL, NULL, NULL), 1);
+	mem_oom(1);
+	EXPECT_EQ(arr_index(&arr, NULL, NULL, NULL), 1);
+	mem_oom(0);
+	EXPECT_NULL(arr.idx);
+	EXPECT_EQ(arr_index(&arr, NULL, NULL, NULL), 0);
+
+	uint id;
+	int value = 5;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 0);
+
+	for (int i = 0; i < 1000; i++) {
+		EXPECT_EQ(arr_addu(&arr, &i, &id), 0);
+		EXPECT_EQ(id, i < 5 ? (uint)i + 2 : i == 5 ? 0 : (uint)i + 1);
+	}
+	EXPECT_EQ(arr.cnt, 1001);
+
+	value = 7;
+	EXPECT_PTR(arr_set(&arr, 0, &value), arr_get(&arr, 0));
+	value = 5;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 1);
+
+	*(int *)arr_get(&arr, 2) = 2000;
+	value			 = 2000;
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+	EXPECT_EQ(arr_reindex(NULL), 1);
+	EXPECT_EQ(arr_reindex(&arr), 0);
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 2);
+	*(int *)arr_get(&arr, 2) = 0;
+	EXPECT_EQ(arr_reindex(&arr), 0);
+
+	*(int *)arr_add(&arr, &id) = 3000;
+	value = 3000;
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 0);
+	EXPECT_EQ(arr_index_sync(NULL), 1);
+	EXPECT_EQ(arr_index_sync(&arr), 0);
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 0);
+	EXPECT_EQ(arr_remove_range(&arr, id, 1), 0);
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+
+	int range[] = {4000, 4001};
+	EXPECT_NOT_NULL(arr_insert_range(&arr, 10, 2, range));
+	value = 4001;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 11);
+	value = 9;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 12);
+	EXPECT_EQ(arr_remove_range(&arr, 10, 2), 0);
+	value = 4000;
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+	value = 9;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 10);
+
+	arr_reset(&arr, 500);
+	value = 600;
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+	value = 400;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 401);
+
+	EXPECT_PTR(arr_sort_radix(&arr, 0, sizeof(int), 1), &arr);
+	value = 7;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(*(int *)arr_get(&arr, id), 7);
+
+	arr_reset(&arr, 0);
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+
+	EXPECT_EQ(arr_index(&arr, t_arr_hash_cb, t_arr_eq_cb, NULL), 0);
+	value = 13;
+	EXPECT_EQ(arr_addu(&arr, &value, NULL), 0);
+	value = 23;
+	EXPECT_EQ(arr_addu(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 0);
+	EXPECT_EQ(arr.cnt, 1);
+
+	arr_unindex(NULL);
+	arr_unindex(&arr);
+	EXPECT_NULL(arr.idx);
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_add_unique_large)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_t src = {0};
+	arr_init(&arr, 1, sizeof(int), ALLOC_STD);
+	arr_init(&src, 200, sizeof(int), ALLOC_STD);
+
+	for (int i = 0; i < 200; i++) {
+		*(int *)arr_add(&src, NULL) = i % 50;
+	}
+
+	EXPECT_PTR(arr_add_unique(&arr, &src), &arr);
+	EXPECT_EQ(arr.cnt, 50);
+	EXPECT_NULL(arr.idx);
+	EXPECT_EQ(*(int *)arr_get(&arr, 49), 49);
+
+	arr_free(&arr);
+	arr_free(&src);
+
+	END;
+}
+
 TEST(arr_add_all)
 {
 	START;
@@ -425,8 +671,343 @@ TEST(arr_merge_unique)
 	EXPECT_EQ(*(int *)arr_get(&arr, 0), 0);
 	EXPECT_EQ(*(int *)arr_get(&arr, 1), 1);
 	EXPECT_EQ(*(int *)arr_get(&arr, 2), 2);
+	arr_free(&arr);
+
+	*(int *)arr_add(&arr0, NULL) = 1;
+	EXPECT_NOT_NULL(arr_merge_unique(&arr, &arr0, &arr1));
+	EXPECT_EQ(arr.cnt, 3);
+	EXPECT_EQ(*(int *)arr_get(&arr, 0), 0);
+	EXPECT_EQ(*(int *)arr_get(&arr, 1), 1);
+	EXPECT_EQ(*(int *)arr_get(&arr, 2), 2);
+	arr_free(&arr);
+
+	*(int *)arr_get(&arr0, 0) = 3;
+	EXPECT_NOT_NULL(arr_merge_unique(&arr, &arr0, &arr1));
+	EXPECT_EQ(arr.cnt, 3);
+	EXPECT_EQ(*(int *)arr_get(&arr, 0), 3);
+	EXPECT_EQ(*(int *)arr_get(&arr, 1), 1);
+	EXPECT_EQ(*(int *)arr_get(&arr, 2), 2);
+	arr_free(&arr);
+
+	arr_reset(&arr0, 0);
+	arr_reset(&arr1, 0);
+	*(int *)arr_add(&arr0, NULL) = 0;
+	*(int *)arr_add(&arr0, NULL) = 2;
+	*(int *)arr_add(&arr1, NULL) = 1;
+	EXPECT_NOT_NULL(arr_merge_unique(&arr, &arr0, &arr1));
+	EXPECT_EQ(arr.cnt, 3);
+	EXPECT_EQ(*(int *)arr_get(&arr, 0), 0);
+	EXPECT_EQ(*(int *)arr_get(&arr, 1), 2);
+	EXPECT_EQ(*(int *)arr_get(&arr, 2), 1);
+
+	arr_free(&arr);
+	arr_free(&arr0);
+	arr_free(&arr1);
+	arr_free(&arrs);
+
+	END;
+}
+
+static int t_arr_cmp_cb(const void *a, const void *b, const void *priv)
+{
+	(void)priv;
+	return (*(int *)a > *(int *)b) - (*(int *)a < *(int *)b);
+}
+
+static void t_arr_sorted_init(arr_t *arr, const int *values, uint cnt)
+{
+	arr_init(arr, cnt, sizeof(int), ALLOC_STD);
+	for (uint i = 0; i < cnt; i++) {
+		*(int *)arr_add(arr, NULL) = values[i];
+	}
+}
+
+TEST(arr_lower_upper_bound)
+{
+	START;
+
+	arr_t arr = {0};
+	t_arr_sorted_init(&arr, (int[]){1, 3, 3, 3, 5}, 5);
+
+	uint id;
+	int value = 3;
+
+	EXPECT_EQ(arr_lower_bound(NULL, NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(arr_lower_bound(&arr, NULL, t_arr_cmp_cb, NULL, NULL), 1);
+	EXPECT_EQ(arr_lower_bound(&arr, &value, NULL, NULL, NULL), 1);
+	EXPECT_EQ(arr_lower_bound(&arr, &value, t_arr_cmp_cb, NULL, NULL), 0);
+	EXPECT_EQ(arr_lower_bound(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 1);
+
+	EXPECT_EQ(arr_upper_bound(NULL, NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(arr_upper_bound(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 4);
+
+	value = 6;
+	EXPECT_EQ(arr_lower_bound(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 5);
+	value = 0;
+	EXPECT_EQ(arr_upper_bound(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 0);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_find_sorted)
+{
+	START;
+
+	arr_t arr = {0};
+	t_arr_sorted_init(&arr, (int[]){1, 3, 3, 5}, 4);
+
+	uint id;
+	int value = 3;
+
+	EXPECT_EQ(arr_find_sorted(NULL, NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(arr_find_sorted(&arr, &value, t_arr_cmp_cb, NULL, NULL), 0);
+	EXPECT_EQ(arr_find_sorted(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 1);
+	value = 4;
+	EXPECT_EQ(arr_find_sorted(&arr, &value, t_arr_cmp_cb, NULL, &id), 1);
+	value = 6;
+	EXPECT_EQ(arr_find_sorted(&arr, &value, t_arr_cmp_cb, NULL, &id), 1);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_add_sorted)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 1, sizeof(int), ALLOC_STD);
+
+	uint id;
+	int value = 3;
+
+	EXPECT_EQ(arr_add_sorted(NULL, NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(arr_add_sorted(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 0);
+	value = 1;
+	EXPECT_EQ(arr_add_sorted(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 0);
+	value = 5;
+	mem_oom(1);
+	EXPECT_EQ(arr_add_sorted(&arr, &value, t_arr_cmp_cb, NULL, &id), 1);
+	mem_oom(0);
+	EXPECT_EQ(arr_add_sorted(&arr, &value, t_arr_cmp_cb, NULL, &id), 0);
+	EXPECT_EQ(id, 2);
+	value = 3;
+	EXPECT_EQ(arr_add_sorted(&arr, &value, t_arr_cmp_cb, NULL, NULL), 0);
+
+	EXPECT_EQ(arr.cnt, 4);
+	EXPECT_EQ(*(int *)arr_get(&arr, 0), 1);
+	EXPECT_EQ(*(int *)arr_get(&arr, 1), 3);
+	EXPECT_EQ(*(int *)arr_get(&arr, 2), 3);
+	EXPECT_EQ(*(int *)arr_get(&arr, 3), 5);
+
+	arr_free(&arr);
+
+	END;
+}
+
+static int t_arr_values(const arr_t *arr, const int *values, uint cnt)
+{
+	if (arr->cnt != cnt) {
+		return 0;
+	}
+
+	for (uint i = 0; i < cnt; i++) {
+		if (*(int *)arr_get(arr, i) != values[i]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+TEST(arr_add_n)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 1, sizeof(int), ALLOC_STD);
+
+	uint id;
+	EXPECT_NULL(arr_add_n(NULL, 0, NULL));
+	log_set_quiet(0, 1);
+	*(int *)arr_add(&arr, NULL) = 0;
+	EXPECT_NULL(arr_add_n(&arr, (uint)-1, NULL));
+	mem_oom(1);
+	EXPECT_NULL(arr_add_n(&arr, 4, NULL));
+	mem_oom(0);
+	log_set_quiet(0, 0);
+
+	int *data = arr_add_n(&arr, 4, &id);
+	EXPECT_NOT_NULL(data);
+	EXPECT_EQ(id, 1);
+	EXPECT_EQ(arr.cnt, 5);
+	EXPECT_EQ(arr.cap, 5);
+	for (int i = 0; i < 4; i++) {
+		data[i] = i + 1;
+	}
+	EXPECT_EQ(*(int *)arr_get(&arr, 4), 4);
+	EXPECT_NOT_NULL(arr_add_n(&arr, 0, NULL));
+	EXPECT_EQ(arr.cnt, 5);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_insert_range)
+{
+	START;
+
+	arr_t arr = {0};
+	t_arr_sorted_init(&arr, (int[]){0, 3}, 2);
+
+	EXPECT_NULL(arr_insert_range(NULL, 0, 0, NULL));
+	log_set_quiet(0, 1);
+	EXPECT_NULL(arr_insert_range(&arr, 3, 1, NULL));
+	mem_oom(1);
+	EXPECT_NULL(arr_insert_range(&arr, 1, 2, NULL));
+	mem_oom(0);
+	log_set_quiet(0, 0);
+
+	arr_index(&arr, NULL, NULL, NULL);
+	EXPECT_PTR(arr_insert_range(&arr, 1, 2, (int[]){1, 2}), arr_get(&arr, 1));
+	EXPECT_PTR(arr_insert_range(&arr, 4, 1, (int[]){4}), arr_get(&arr, 4));
+	EXPECT_NOT_NULL(arr_insert_range(&arr, 0, 1, NULL));
+	*(int *)arr_get(&arr, 0) = -1;
+	EXPECT_EQ(t_arr_values(&arr, (int[]){-1, 0, 1, 2, 3, 4}, 6), 1);
+
+	uint id;
+	int value = 3;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 4);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_remove_range)
+{
+	START;
+
+	arr_t arr = {0};
+	t_arr_sorted_init(&arr, (int[]){0, 1, 2, 3, 4}, 5);
+	arr_index(&arr, NULL, NULL, NULL);
+
+	EXPECT_EQ(arr_remove_range(NULL, 0, 0), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(arr_remove_range(&arr, 6, 0), 1);
+	EXPECT_EQ(arr_remove_range(&arr, 3, 3), 1);
+	log_set_quiet(0, 0);
+	EXPECT_EQ(arr_remove_range(&arr, 1, 2), 0);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){0, 3, 4}, 3), 1);
+	EXPECT_EQ(arr_remove_range(&arr, 3, 0), 0);
+	EXPECT_EQ(arr_remove_range(&arr, 2, 1), 0);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){0, 3}, 2), 1);
+
+	int value = 4;
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+	value = 3;
+	uint id;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 1);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_remove_swap)
+{
+	START;
+
+	arr_t arr = {0};
+	t_arr_sorted_init(&arr, (int[]){0, 1, 2, 3}, 4);
+	arr_index(&arr, NULL, NULL, NULL);
+
+	EXPECT_EQ(arr_remove_swap(NULL, 0), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(arr_remove_swap(&arr, 4), 1);
+	log_set_quiet(0, 0);
+	EXPECT_EQ(arr_remove_swap(&arr, 1), 0);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){0, 3, 2}, 3), 1);
+	EXPECT_EQ(arr_remove_swap(&arr, 2), 0);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){0, 3}, 2), 1);
+
+	uint id;
+	int value = 3;
+	EXPECT_EQ(arr_find(&arr, &value, &id), 0);
+	EXPECT_EQ(id, 1);
+	value = 1;
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
+	value = 2;
+	EXPECT_EQ(arr_find(&arr, &value, NULL), 1);
 
 	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_sorted_sets)
+{
+	START;
+
+	arr_t arr  = {0};
+	arr_t arr0 = {0};
+	arr_t arr1 = {0};
+	arr_t arrs = {0};
+
+	t_arr_sorted_init(&arr0, (int[]){0, 1, 3, 5}, 4);
+	t_arr_sorted_init(&arr1, (int[]){1, 2, 3, 6}, 4);
+	arr_init(&arrs, 1, sizeof(long long), ALLOC_STD);
+
+	EXPECT_NULL(arr_union(NULL, &arr0, &arr1, t_arr_cmp_cb, NULL));
+	EXPECT_NULL(arr_union(&arr, NULL, &arr1, t_arr_cmp_cb, NULL));
+	EXPECT_NULL(arr_union(&arr, &arr0, NULL, t_arr_cmp_cb, NULL));
+	EXPECT_NULL(arr_union(&arr, &arr0, &arr1, NULL, NULL));
+	EXPECT_NULL(arr_union(&arr, &arr0, &arrs, t_arr_cmp_cb, NULL));
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_NULL(arr_union(&arr, &arr0, &arr1, t_arr_cmp_cb, NULL));
+	log_set_quiet(0, 0);
+	mem_oom(0);
+
+	EXPECT_PTR(arr_merge_sorted(&arr, &arr0, &arr1, t_arr_cmp_cb, NULL), &arr);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){0, 1, 1, 2, 3, 3, 5, 6}, 8), 1);
+	arr_free(&arr);
+
+	EXPECT_PTR(arr_union(&arr, &arr0, &arr1, t_arr_cmp_cb, NULL), &arr);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){0, 1, 2, 3, 5, 6}, 6), 1);
+	arr_free(&arr);
+
+	arr_t dup0 = {0};
+	arr_t dup1 = {0};
+	t_arr_sorted_init(&dup0, (int[]){1, 1, 4}, 3);
+	t_arr_sorted_init(&dup1, (int[]){1, 4, 4, 7, 7}, 5);
+	EXPECT_PTR(arr_union(&arr, &dup0, &dup1, t_arr_cmp_cb, NULL), &arr);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){1, 4, 7}, 3), 1);
+	arr_free(&arr);
+	arr_free(&dup0);
+	arr_free(&dup1);
+
+	EXPECT_PTR(arr_intersect(&arr, &arr0, &arr1, t_arr_cmp_cb, NULL), &arr);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){1, 3}, 2), 1);
+	arr_free(&arr);
+
+	EXPECT_PTR(arr_diff(&arr, &arr0, &arr1, t_arr_cmp_cb, NULL), &arr);
+	EXPECT_EQ(t_arr_values(&arr, (int[]){0, 5}, 2), 1);
+	arr_free(&arr);
+
 	arr_free(&arr0);
 	arr_free(&arr1);
 	arr_free(&arrs);
@@ -466,6 +1047,220 @@ TEST(arr_sort)
 	END;
 }
 
+static void t_arr_sort_fill(arr_t *arr, uint cnt, int mode)
+{
+	arr_reset(arr, 0);
+	uint seed = 12345;
+	for (uint i = 0; i < cnt; i++) {
+		seed  = seed * 1103515245 + 12345;
+		int v = mode == 0 ? (int)(seed >> 8) % 1000 - 500 : mode == 1 ? (int)i : mode == 2 ? (int)(cnt - i) : 7;
+
+		*(int *)arr_add(arr, NULL) = v;
+	}
+}
+
+static int t_arr_sorted(const arr_t *arr)
+{
+	for (uint i = 1; i < arr->cnt; i++) {
+		if (*(int *)arr_get(arr, i - 1) > *(int *)arr_get(arr, i)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+TEST(arr_sort_large)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 1000, sizeof(int), ALLOC_STD);
+
+	for (int mode = 0; mode < 4; mode++) {
+		t_arr_sort_fill(&arr, 1000, mode);
+		EXPECT_PTR(arr_sort(&arr, t_arr_sort_cb, NULL), &arr);
+		EXPECT_EQ(t_arr_sorted(&arr), 1);
+	}
+
+	arr_free(&arr);
+
+	END;
+}
+
+typedef struct t_arr_pair_s {
+	int key;
+	uint ord;
+} t_arr_pair_t;
+
+static int t_arr_pair_cb(const void *a, const void *b, const void *priv)
+{
+	(void)priv;
+	return ((const t_arr_pair_t *)a)->key - ((const t_arr_pair_t *)b)->key;
+}
+
+TEST(arr_sort_stable)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 100, sizeof(t_arr_pair_t), ALLOC_STD);
+
+	for (uint i = 0; i < 100; i++) {
+		*(t_arr_pair_t *)arr_add(&arr, NULL) = (t_arr_pair_t){.key = (int)(i * 7 % 5), .ord = i};
+	}
+
+	EXPECT_NULL(arr_sort_stable(NULL, NULL, NULL));
+	EXPECT_PTR(arr_sort_stable(&arr, NULL, NULL), &arr);
+	mem_oom(1);
+	EXPECT_NULL(arr_sort_stable(&arr, t_arr_pair_cb, NULL));
+	mem_oom(0);
+	EXPECT_PTR(arr_sort_stable(&arr, t_arr_pair_cb, NULL), &arr);
+
+	int ok = 1;
+	for (uint i = 1; i < arr.cnt; i++) {
+		const t_arr_pair_t *prev = arr_get(&arr, i - 1);
+		const t_arr_pair_t *cur	 = arr_get(&arr, i);
+		ok &= prev->key < cur->key || (prev->key == cur->key && prev->ord < cur->ord);
+	}
+	EXPECT_EQ(ok, 1);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_sort_par)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 100000, sizeof(int), ALLOC_STD);
+
+	t_arr_sort_fill(&arr, 100, 0);
+
+	EXPECT_NULL(arr_sort_par(NULL, NULL, NULL, 0));
+	EXPECT_PTR(arr_sort_par(&arr, NULL, NULL, 0), &arr);
+	EXPECT_PTR(arr_sort_par(&arr, t_arr_sort_cb, NULL, 4), &arr);
+	EXPECT_EQ(t_arr_sorted(&arr), 1);
+
+	t_arr_sort_fill(&arr, 100000, 0);
+
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_NULL(arr_sort_par(&arr, t_arr_sort_cb, NULL, 4));
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_PTR(arr_sort_par(&arr, t_arr_sort_cb, NULL, 4), &arr);
+	EXPECT_EQ(t_arr_sorted(&arr), 1);
+	EXPECT_PTR(arr_sort_par(&arr, t_arr_sort_cb, NULL, 0), &arr);
+	EXPECT_EQ(t_arr_sorted(&arr), 1);
+
+	t_arr_sort_fill(&arr, 100000, 0);
+	EXPECT_PTR(arr_sort_par(&arr, t_arr_sort_cb, NULL, 2), &arr);
+	EXPECT_EQ(t_arr_sorted(&arr), 1);
+
+	t_arr_sort_fill(&arr, 200000, 0);
+	EXPECT_PTR(arr_sort_par(&arr, t_arr_sort_cb, NULL, 8), &arr);
+	EXPECT_EQ(t_arr_sorted(&arr), 1);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_sort_idx)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 4, sizeof(int), ALLOC_STD);
+
+	*(int *)arr_add(&arr, NULL) = 3;
+	*(int *)arr_add(&arr, NULL) = 1;
+	*(int *)arr_add(&arr, NULL) = 2;
+	*(int *)arr_add(&arr, NULL) = 0;
+
+	uint ids[4] = {0};
+
+	EXPECT_EQ(arr_sort_idx(NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(arr_sort_idx(&arr, NULL, NULL, ids), 1);
+	EXPECT_EQ(arr_sort_idx(&arr, t_arr_sort_cb, NULL, NULL), 1);
+	EXPECT_EQ(arr_sort_idx(&arr, t_arr_sort_cb, NULL, ids), 0);
+
+	EXPECT_EQ(ids[0], 3);
+	EXPECT_EQ(ids[1], 1);
+	EXPECT_EQ(ids[2], 2);
+	EXPECT_EQ(ids[3], 0);
+	EXPECT_EQ(*(int *)arr_get(&arr, 0), 3);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_sort_ind)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 500, sizeof(int), ALLOC_STD);
+
+	t_arr_sort_fill(&arr, 500, 0);
+
+	EXPECT_NULL(arr_sort_ind(NULL, NULL, NULL));
+	EXPECT_PTR(arr_sort_ind(&arr, NULL, NULL), &arr);
+	mem_oom(1);
+	EXPECT_NULL(arr_sort_ind(&arr, t_arr_sort_cb, NULL));
+	mem_oom(0);
+	EXPECT_PTR(arr_sort_ind(&arr, t_arr_sort_cb, NULL), &arr);
+	EXPECT_EQ(t_arr_sorted(&arr), 1);
+
+	arr_free(&arr);
+
+	END;
+}
+
+TEST(arr_sort_radix)
+{
+	START;
+
+	arr_t arr = {0};
+	arr_init(&arr, 1000, sizeof(int), ALLOC_STD);
+
+	t_arr_sort_fill(&arr, 1000, 0);
+
+	EXPECT_NULL(arr_sort_radix(NULL, 0, sizeof(int), 1));
+	log_set_quiet(0, 1);
+	EXPECT_NULL(arr_sort_radix(&arr, 0, 3, 1));
+	EXPECT_NULL(arr_sort_radix(&arr, 2, sizeof(int), 1));
+	mem_oom(1);
+	EXPECT_NULL(arr_sort_radix(&arr, 0, sizeof(int), 1));
+	mem_oom(0);
+	log_set_quiet(0, 0);
+	EXPECT_PTR(arr_sort_radix(&arr, 0, sizeof(int), 1), &arr);
+	EXPECT_EQ(t_arr_sorted(&arr), 1);
+
+	arr_free(&arr);
+
+	arr_init(&arr, 4, sizeof(t_arr_pair_t), ALLOC_STD);
+
+	*(t_arr_pair_t *)arr_add(&arr, NULL) = (t_arr_pair_t){.key = 0, .ord = 300};
+	*(t_arr_pair_t *)arr_add(&arr, NULL) = (t_arr_pair_t){.key = 1, .ord = 2};
+	*(t_arr_pair_t *)arr_add(&arr, NULL) = (t_arr_pair_t){.key = 2, .ord = 70000};
+	*(t_arr_pair_t *)arr_add(&arr, NULL) = (t_arr_pair_t){.key = 3, .ord = 2};
+
+	EXPECT_PTR(arr_sort_radix(&arr, offsetof(t_arr_pair_t, ord), sizeof(uint), 0), &arr);
+
+	EXPECT_EQ(((t_arr_pair_t *)arr_get(&arr, 0))->key, 1);
+	EXPECT_EQ(((t_arr_pair_t *)arr_get(&arr, 1))->key, 3);
+	EXPECT_EQ(((t_arr_pair_t *)arr_get(&arr, 2))->key, 0);
+	EXPECT_EQ(((t_arr_pair_t *)arr_get(&arr, 3))->key, 2);
+
+	arr_free(&arr);
+
+	END;
+}
+
 TEST(arr_foreach)
 {
 	START;
@@ -526,8 +1321,12 @@ STEST(arr)
 	SSTART;
 
 	RUN(arr_init_free);
+	RUN(arr_init_a);
 	RUN(arr_reset);
 	RUN(arr_resize);
+	RUN(arr_reserve);
+	RUN(arr_shrink);
+	RUN(arr_set_grow);
 	RUN(arr_add);
 	RUN(arr_get);
 	RUN(arr_set);
@@ -535,11 +1334,27 @@ STEST(arr)
 	RUN(arr_addu);
 	RUN(arr_find);
 	RUN(arr_find_cmp);
+	RUN(arr_index);
 	RUN(arr_add_all);
 	RUN(arr_add_unique);
+	RUN(arr_add_unique_large);
 	RUN(arr_merge_all);
 	RUN(arr_merge_unique);
+	RUN(arr_lower_upper_bound);
+	RUN(arr_find_sorted);
+	RUN(arr_add_sorted);
+	RUN(arr_sorted_sets);
+	RUN(arr_add_n);
+	RUN(arr_insert_range);
+	RUN(arr_remove_range);
+	RUN(arr_remove_swap);
 	RUN(arr_sort);
+	RUN(arr_sort_large);
+	RUN(arr_sort_stable);
+	RUN(arr_sort_par);
+	RUN(arr_sort_idx);
+	RUN(arr_sort_ind);
+	RUN(arr_sort_radix);
 	RUN(arr_foreach);
 	RUN(arr_print);
 
@@ -30,6 +30,32 @@ TEST(buf_init_free)
 	END;
 }
 
+TEST(buf_init_a)
+{
+	START;
+
+	buf_t buf = {0};
+
+	EXPECT_NULL(buf_init_a(NULL, 0, 64, ALLOC_STD));
+	mem_oom(1);
+	EXPECT_NULL(buf_init_a(&buf, 1, 64, ALLOC_STD));
+	mem_oom(0);
+	EXPECT_PTR(buf_init_a(&buf, 1, 64, ALLOC_STD), &buf);
+
+	EXPECT_EQ((size_t)buf.data & 63, 0);
+	EXPECT_EQ(buf.align, 64);
+
+	EXPECT_EQ(buf_add(&buf, 4, "abcd", NULL), 0);
+	EXPECT_EQ(buf_resize(&buf, 1024), 0);
+
+	EXPECT_EQ((size_t)buf.data & 63, 0);
+	EXPECT_EQ(buf_cmp(&buf, 0, 4, "abcd"), 0);
+
+	buf_free(&buf);
+
+	END;
+}
+
 TEST(buf_reset)
 {
 	START;
@@ -65,6 +91,65 @@ TEST(buf_resize)
 	END;
 }
 
+TEST(buf_reserve)
+{
+	START;
+
+	buf_t buf = {0};
+	buf_init(&buf, 4, ALLOC_STD);
+
+	EXPECT_EQ(buf_reserve(NULL, 0), 1);
+	EXPECT_EQ(buf_reserve(&buf, 2), 0);
+	EXPECT_EQ(buf.size, 4);
+	EXPECT_EQ(buf_reserve(&buf, 5), 0);
+	EXPECT_EQ(buf.size, 8);
+
+	buf_set_grow(NULL, (grow_t){0});
+	buf_set_grow(&buf, (grow_t){.exact = 1});
+	EXPECT_EQ(buf_reserve(&buf, 9), 0);
+	EXPECT_EQ(buf.size, 9);
+	mem_oom(1);
+	EXPECT_EQ(buf_reserve(&buf, 10), 1);
+	mem_oom(0);
+
+	buf_set_grow(&buf, (grow_t){.step = 4});
+	EXPECT_EQ(buf_add(&buf, 10, NULL, NULL), 1);
+	EXPECT_EQ(buf_add(&buf, 0, NULL, NULL), 0);
+	uint val = 1;
+	for (int i = 0; i < 3; i++) {
+		buf_add(&buf, sizeof(val), &val, NULL);
+	}
+	EXPECT_EQ(buf.size, 13);
+
+	buf_free(&buf);
+
+	END;
+}
+
+TEST(buf_shrink)
+{
+	START;
+
+	buf_t buf = {0};
+	buf_init(&buf, 16, ALLOC_STD);
+
+	EXPECT_EQ(buf_shrink(NULL), 1);
+	EXPECT_EQ(buf_shrink(&buf), 0);
+	EXPECT_EQ(buf.size, 1);
+
+	buf_reserve(&buf, 16);
+	buf_write_u32le(&buf, 1);
+	EXPECT_EQ(buf.size, 16);
+	EXPECT_EQ(buf_shrink(&buf), 0);
+	EXPECT_EQ(buf.size, 4);
+	EXPECT_EQ(buf_shrink(&buf), 0);
+	EXPECT_EQ(*(u8 *)buf_get(&buf, 0), 1);
+
+	buf_free(&buf);
+
+	END;
+}
+
 TEST(buf_set)
 {
 	START;
@@ -971,8 +1056,11 @@ STEST(buf)
 	SSTART;
 
 	RUN(buf_init_free);
+	RUN(buf_init_a);
 	RUN(buf_reset);
 	RUN(buf_resize);
+	RUN(buf_reserve);
+	RUN(buf_shrink);
 	RUN(buf_set);
 	RUN(buf_add);
 	RUN(buf_write_le);
@@ -0,0 +1,250 @@
+#include "cmap.h"
+
+#include "log.h"
+#include "mem.h"
+#include "sync.h"
+#include "test.h"
+
+TEST(cmap_init_free)
+{
+	START;
+
+	cmap_t map = {0};
+
+	EXPECT_NULL(cmap_init(NULL, 0, ALLOC_STD));
+	EXPECT_NULL(cmap_init(&map, 0, ALLOC_STD));
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_NULL(cmap_init(&map, 4, ALLOC_STD));
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_PTR(cmap_init(&map, 5, ALLOC_STD), &map);
+	EXPECT_EQ(map.cnt, 8);
+
+	const mem_stats_t *stats = mem_stats_get();
+
+	int allocs = stats->allocs;
+	mem_free(mem_alloc(1), 1);
+	EXPECT_EQ(stats->allocs, allocs);
+
+	cmap_free(&map);
+	cmap_free(&map);
+	cmap_free(NULL);
+
+	EXPECT_NULL(map.stripes);
+
+	allocs = stats->allocs;
+	mem_free(mem_alloc(1), 1);
+	EXPECT_EQ(stats->allocs, allocs + 1);
+
+	END;
+}
+
+TEST(cmap_set_get_remove)
+{
+	START;
+
+	cmap_t map = {0};
+	cmap_init(&map, 4, ALLOC_STD);
+
+	int a = 1, b = 2;
+	void *value;
+
+	EXPECT_EQ(cmap_set(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(cmap_set(&map, NULL, 0, NULL), 1);
+	EXPECT_EQ(cmap_get(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(cmap_get(&map, NULL, 0, NULL), 1);
+	EXPECT_EQ(cmap_remove(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(cmap_remove(&map, NULL, 0, NULL), 1);
+
+	EXPECT_EQ(cmap_set(&map, "a", 1, &a), 0);
+	EXPECT_EQ(cmap_set(&map, "b", 1, &b), 0);
+	EXPECT_EQ(cmap_get(&map, "a", 1, &value), 0);
+	EXPECT_PTR(value, &a);
+	EXPECT_EQ(cmap_count(&map), 2);
+	EXPECT_EQ(cmap_count(NULL), 0);
+
+	EXPECT_EQ(cmap_remove(&map, "a", 1, &value), 0);
+	EXPECT_PTR(value, &a);
+	EXPECT_EQ(cmap_remove(&map, "a", 1, NULL), 1);
+	EXPECT_EQ(cmap_get(&map, "a", 1, NULL), 1);
+	EXPECT_EQ(cmap_count(&map), 1);
+
+	cmap_free(&map);
+
+	END;
+}
+
+static u64 t_cmap_hash_cb(const void *key, size_t ksize, const void *priv)
+{
+	(void)priv;
+	u64 hash = 0;
+	for (size_t i = 0; i < ksize; i++) {
+		hash = hash * 31 + (((const char *)key)[i] | 0x20);
+	}
+	return hash * 0x9e3779b97f4a7c15ULL;
+}
+
+static int t_cmap_eq_cb(const void *key1, size_t ksize1, const void *key2, size_t ksize2, const void *priv)
+{
+	(void)priv;
+	if (ksize1 != ksize2) {
+		return 0;
+	}
+	for (size_t i = 0; i < ksize1; i++) {
+		if ((((const char *)key1)[i] | 0x20) != (((const char *)key2)[i] | 0x20)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+TEST(cmap_set_hash)
+{
+	START;
+
+	cmap_t map = {0};
+	cmap_init(&map, 4, ALLOC_STD);
+
+	EXPECT_EQ(cmap_set_hash(NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(cmap_set_hash(&map, t_cmap_hash_cb, t_cmap_eq_cb, NULL), 0);
+
+	int a = 1;
+	EXPECT_EQ(cmap_set(&map, "One", 3, &a), 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(cmap_set_hash(&map, NULL, NULL, NULL), 1);
+	log_set_quiet(0, 0);
+
+	void *value;
+	EXPECT_EQ(cmap_get(&map, "oNE", 3, &value), 0);
+	EXPECT_PTR(value, &a);
+	EXPECT_EQ(cmap_remove(&map, "ONE", 3, NULL), 0);
+	EXPECT_EQ(cmap_count(&map), 0);
+
+	cmap_free(&map);
+
+	END;
+}
+
+static void *t_cmap_compute_cb(const void *key, size_t ksize, void *priv)
+{
+	(void)key;
+	(void)ksize;
+	atom_add(priv, 1);
+	return priv;
+}
+
+static void *t_cmap_null_cb(const void *key, size_t ksize, void *priv)
+{
+	(void)key;
+	(void)ksize;
+	(void)priv;
+	return NULL;
+}
+
+TEST(cmap_compute)
+{
+	START;
+
+	cmap_t map = {0};
+	cmap_init(&map, 4, ALLOC_STD);
+
+	volatile size_t calls = 0;
+	void *value	      = NULL;
+
+	EXPECT_EQ(cmap_compute(NULL, NULL, 0, NULL, NULL, NULL), 1);
+	EXPECT_EQ(cmap_compute(&map, "a", 1, NULL, NULL, NULL), 1);
+	EXPECT_EQ(cmap_compute(&map, "a", 1, t_cmap_null_cb, NULL, &value), 1);
+	EXPECT_EQ(cmap_get(&map, "a", 1, NULL), 1);
+
+	EXPECT_EQ(cmap_compute(&map, "a", 1, t_cmap_compute_cb, (void *)&calls, &value), 0);
+	EXPECT_PTR(value, &calls);
+	EXPECT_EQ(cmap_compute(&map, "a", 1, t_cmap_compute_cb, (void *)&calls, NULL), 0);
+	EXPECT_EQ(calls, 1);
+
+	cmap_free(&map);
+
+	END;
+}
+
+typedef struct t_cmap_worker_s {
+	cmap_t *map;
+	uint id;
+	uint keys[1000];
+	volatile size_t *calls;
+	int fails;
+} t_cmap_worker_t;
+
+static void t_cmap_worker(void *priv)
+{
+	t_cmap_worker_t *worker = priv;
+
+	for (uint i = 0; i < 1000; i++) {
+		worker->keys[i] = worker->id * 1000 + i;
+		worker->fails += cmap_set(worker->map, &worker->keys[i], sizeof(uint), &worker->keys[i]);
+	}
+
+	for (uint i = 0; i < 1000; i++) {
+		void *value = NULL;
+		worker->fails += cmap_get(worker->map, &worker->keys[i], sizeof(uint), &value) || value != &worker->keys[i];
+		worker->fails += cmap_compute(worker->map, "shared", 6, t_cmap_compute_cb, (void *)worker->calls, NULL);
+	}
+
+	for (uint i = 0; i < 1000; i += 2) {
+		worker->fails += cmap_remove(worker->map, &worker->keys[i], sizeof(uint), NULL);
+	}
+}
+
+#define T_CMAP_THREADS 64
+
+static int t_cmap_run(uint cnt)
+{
+	static t_cmap_worker_t workers[T_CMAP_THREADS];
+	thread_t threads[T_CMAP_THREADS];
+
+	cmap_t map = {0};
+	cmap_init(&map, 16, ALLOC_STD);
+
+	volatile size_t calls = 0;
+	for (uint i = 0; i < cnt; i++) {
+		workers[i] = (t_cmap_worker_t){.map = &map, .id = i, .calls = &calls};
+		thread_create(&threads[i], t_cmap_worker, &workers[i]);
+	}
+
+	int fails = 0;
+	for (uint i = 0; i < cnt; i++) {
+		thread_join(&threads[i]);
+		fails += workers[i].fails;
+	}
+
+	int ok = fails == 0 && calls == 1 && cmap_count(&map) == cnt * 500 + 1;
+
+	cmap_free(&map);
+
+	return ok;
+}
+
+TEST(cmap_threads)
+{
+	START;
+
+	for (uint cnt = 1; cnt <= T_CMAP_THREADS; cnt *= 2) {
+		EXPECT_EQ(t_cmap_run(cnt), 1);
+	}
+
+	END;
+}
+
+STEST(cmap)
+{
+	SSTART;
+
+	RUN(cmap_init_free);
+	RUN(cmap_set_get_remove);
+	RUN(cmap_set_hash);
+	RUN(cmap_compute);
+	RUN(cmap_threads);
+
+	SEND;
+}
@@ -1,19 +1,24 @@
 #include "dict.h"
 
+#include "arena.h"
+#include "log.h"
 #include "mem.h"
 #include "test.h"
 
+#include <stdio.h>
+
 TEST(dict_init_free)
 {
 	START;
 
 	dict_t dict = {0};
 
-	EXPECT_NULL(dict_init(NULL, 0));
+	EXPECT_NULL(dict_init(NULL, 0, ALLOC_STD));
+	EXPECT_NULL(dict_init(&dict, 0, ALLOC_STD));
 	mem_oom(1);
-	EXPECT_NULL(dict_init(&dict, 1));
+	EXPECT_NULL(dict_init(&dict, 1, ALLOC_STD));
 	mem_oom(0);
-	EXPECT_PTR(dict_init(&dict, 1), &dict);
+	EXPECT_PTR(dict_init(&dict, 1, ALLOC_STD), &dict);
 
 	dict_free(NULL);
 	dict_free(&dict);
@@ -27,7 +32,7 @@ TEST(dict_set_get)
 
 	dict_t dict = {0};
 
-	EXPECT_PTR(dict_init(&dict, 2), &dict);
+	EXPECT_PTR(dict_init(&dict, 2, ALLOC_STD), &dict);
 
 	dict_set(NULL, NULL, 0, NULL);
 	dict_set(&dict, "one", 3, "1");
@@ -55,7 +60,7 @@ TEST(dict_foreach)
 
 	dict_t dict = {0};
 
-	EXPECT_PTR(dict_init(&dict, 4), &dict);
+	EXPECT_PTR(dict_init(&dict, 4, ALLOC_STD), &dict);
 
 	dict_set(&dict, "one", 3, "1");
 	dict_set(&dict, "two", 3, "2");
@@ -81,11 +86,232 @@ TEST(dict_foreach)
 	END;
 }
 
+TEST(dict_remove)
+{
+	START;
+
+	dict_t dict = {0};
+	dict_init(&dict, 8, ALLOC_STD);
+
+	int keys[64];
+	for (int i = 0; i < 64; i++) {
+		keys[i] = i;
+		dict_set(&dict, &keys[i], sizeof(int), &keys[i]);
+	}
+
+	void *val;
+	EXPECT_EQ(dict_remove(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(dict_remove(&dict, NULL, 0, NULL), 1);
+	EXPECT_EQ(dict_remove(&dict, "x", 1, NULL), 1);
+
+	int ok = 1;
+	for (int i = 0; i < 64; i += 3) {
+		ok &= dict_remove(&dict, &keys[i], sizeof(int), &val) == 0 && val == &keys[i];
+	}
+	EXPECT_EQ(ok, 1);
+	EXPECT_EQ(dict.count, 42);
+
+	for (int i = 0; i < 64; i++) {
+		ok &= dict_get(&dict, &keys[i], sizeof(int), &val) == (i % 3 == 0) && (i % 3 == 0 || val == &keys[i]);
+	}
+	EXPECT_EQ(ok, 1);
+
+	int prev = -1;
+	int cnt	 = 0;
+	dict_foreach(&dict, pair)
+	{
+		int cur = *(int *)pair->key;
+		ok &= cur > prev && cur % 3 != 0 && (pair->next == NULL || pair->next->prev == pair);
+		prev = cur;
+		cnt++;
+	}
+	EXPECT_EQ(ok, 1);
+	EXPECT_EQ(cnt, 42);
+	EXPECT_PTR(dict.last->key, &keys[62]);
+
+	dict_set(&dict, &keys[0], sizeof(int), NULL);
+	EXPECT_PTR(dict.last->key, &keys[0]);
+
+	dict_free(&dict);
+
+	END;
+}
+
+TEST(dict_reset)
+{
+	START;
+
+	dict_t dict = {0};
+	dict_init(&dict, 4, ALLOC_STD);
+
+	dict_set(&dict, "one", 3, "1");
+
+	dict_reset(NULL);
+	dict_reset(&dict);
+
+	EXPECT_EQ(dict.count, 0);
+	EXPECT_EQ(dict.capacity, 4);
+	EXPECT_NULL(dict.first);
+	EXPECT_EQ(dict_get(&dict, "one", 3, NULL), 1);
+	EXPECT_EQ(dict_set(&dict, "two", 3, "2"), 0);
+	EXPECT_PTR(dict.first, dict.last);
+
+	dict_free(&dict);
+
+	END;
+}
+
+TEST(dict_reserve)
+{
+	START;
+
+	dict_t dict = {0};
+	dict_init(&dict, 4, ALLOC_STD);
+
+	dict_set(&dict, "one", 3, "1");
+	dict_set(&dict, "two", 3, "2");
+
+	EXPECT_EQ(dict_reserve(NULL, 0), 1);
+	EXPECT_EQ(dict_reserve(&dict, 3), 0);
+	EXPECT_EQ(dict.capacity, 4);
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(dict_reserve(&dict, 100), 1);
+	EXPECT_EQ(dict_set(&dict, "three", 5, "3"), 0);
+	EXPECT_EQ(dict_set(&dict, "four", 4, "4"), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(dict_reserve(&dict, 100), 0);
+	EXPECT_EQ(dict.capacity, 256);
+
+	char *val = NULL;
+	EXPECT_EQ(dict_get(&dict, "two", 3, (void **)&val), 0);
+	EXPECT_STR(val, "2");
+	EXPECT_STR(dict.first->value, "1");
+	EXPECT_STR(dict.last->value, "3");
+
+	dict_free(&dict);
+
+	END;
+}
+
+TEST(dict_arena)
+{
+	START;
+
+	arena_t arena = {0};
+	arena_init(&arena, 1024, ALLOC_STD);
+
+	dict_t dict = {0};
+	EXPECT_PTR(dict_init(&dict, 2, ALLOC_ARENA(&arena)), &dict);
+
+	dict_set(&dict, "one", 3, "1");
+	dict_set(&dict, "two", 3, "2");
+	dict_set(&dict, "three", 5, "3");
+
+	char *val = NULL;
+	EXPECT_EQ(dict_get(&dict, "three", 5, (void **)&val), 0);
+	EXPECT_STR(val, "3");
+
+	dict_free(&dict);
+	arena_free(&arena);
+
+	END;
+}
+
+static u64 t_dict_hash_cb(const void *key, size_t ksize, const void *priv)
+{
+	(void)priv;
+	u64 hash = 0;
+	for (size_t i = 0; i < ksize; i++) {
+		hash = hash * 31 + (((const char *)key)[i] | 0x20);
+	}
+	return hash;
+}
+
+static int t_dict_eq_cb(const void *key1, size_t ksize1, const void *key2, size_t ksize2, const void *priv)
+{
+	(void)priv;
+	if (ksize1 != ksize2) {
+		return 0;
+	}
+	for (size_t i = 0; i < ksize1; i++) {
+		if ((((const char *)key1)[i] | 0x20) != (((const char *)key2)[i] | 0x20)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+TEST(dict_set_hash)
+{
+	START;
+
+	dict_t dict = {0};
+	dict_init(&dict, 4, ALLOC_STD);
+
+	EXPECT_EQ(dict_set_hash(NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(dict_set_hash(&dict, t_dict_hash_cb, t_dict_eq_cb, NULL), 0);
+
+	dict_set(&dict, "One", 3, "1");
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(dict_set_hash(&dict, NULL, NULL, NULL), 1);
+	log_set_quiet(0, 0);
+
+	char *val = NULL;
+	EXPECT_EQ(dict_get(&dict, "oNE", 3, (void **)&val), 0);
+	EXPECT_STR(val, "1");
+	EXPECT_EQ(dict_remove(&dict, "ONE", 3, NULL), 0);
+	EXPECT_EQ(dict.count, 0);
+
+	dict_free(&dict);
+
+	END;
+}
+
+TEST(dict_probes)
+{
+	START;
+
+	dict_t dict = {0};
+	dict_init(&dict, 16, ALLOC_STD);
+
+	char keys[1000][32];
+	for (int i = 0; i < 1000; i++) {
+		int len = snprintf(keys[i], sizeof(keys[i]), "/usr/lib/module/%d.so", i);
+		dict_set(&dict, keys[i], (size_t)len, NULL);
+	}
+
+	size_t total, max;
+	EXPECT_EQ(dict_probes(NULL, NULL, NULL), 1);
+	EXPECT_EQ(dict_probes(&dict, NULL, NULL), 0);
+	EXPECT_EQ(dict_probes(&dict, &total, &max), 0);
+	EXPECT_GT(total, 999);
+	EXPECT_LT(total, 3000);
+	EXPECT_LT(max, 64);
+
+	char buf[128] = {0};
+	EXPECT_EQ(dict_print_probes(NULL, DST_BUF(buf)), 0);
+	EXPECT_GT(dict_print_probes(&dict, DST_BUF(buf)), 0);
+	EXPECT_STRN(buf, "count: 1000 capacity: 2048 probes: avg ", 39);
+
+	dict_free(&dict);
+
+	END;
+}
+
 STEST(dict)
 {
 	SSTART;
 	RUN(dict_init_free);
 	RUN(dict_set_get);
 	RUN(dict_foreach);
+	RUN(dict_remove);
+	RUN(dict_reset);
+	RUN(dict_reserve);
+	RUN(dict_arena);
+	RUN(dict_set_hash);
+	RUN(dict_probes);
 	SEND;
 }
@@ -0,0 +1,236 @@
+#include "dlist.h"
+
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+static size_t t_dlist_values(const dlist_t *list, int *values)
+{
+	size_t cnt = 0;
+	dlist_node_t node;
+	int *value;
+	dlist_foreach(list, node, value)
+	{
+		values[cnt++] = *value;
+	}
+
+	return cnt;
+}
+
+TEST(dlist_init_free)
+{
+	START;
+
+	dlist_t list = {0};
+
+	EXPECT_NULL(dlist_init(NULL, 0, sizeof(int), ALLOC_STD));
+	mem_oom(1);
+	EXPECT_NULL(dlist_init(&list, 1, sizeof(int), ALLOC_STD));
+	mem_oom(0);
+	EXPECT_PTR(dlist_init(&list, 1, sizeof(int), ALLOC_STD), &list);
+
+	EXPECT_NOT_NULL(list.nodes.data);
+	EXPECT_EQ(list.head, DLIST_END);
+	EXPECT_EQ(list.tail, DLIST_END);
+	EXPECT_EQ(list.cnt, 0);
+
+	dlist_free(&list);
+	dlist_free(NULL);
+
+	EXPECT_NULL(list.nodes.data);
+
+	END;
+}
+
+TEST(dlist_node)
+{
+	START;
+
+	dlist_t list = {0};
+	dlist_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	dlist_node_t node;
+
+	EXPECT_NULL(dlist_node(NULL, NULL));
+	EXPECT_NOT_NULL(dlist_node(&list, &node));
+	EXPECT_EQ(node, 0);
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_NULL(dlist_node(&list, NULL));
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(list.cnt, 0);
+	EXPECT_EQ(list.nodes.cnt, 1);
+
+	dlist_free(&list);
+
+	END;
+}
+
+TEST(dlist_app_prep_ins)
+{
+	START;
+
+	dlist_t list = {0};
+	dlist_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	dlist_node_t n[4];
+	for (int i = 0; i < 4; i++) {
+		*(int *)dlist_node(&list, &n[i]) = i;
+	}
+
+	EXPECT_EQ(dlist_app(NULL, n[0]), 1);
+	EXPECT_EQ(dlist_prep(NULL, n[0]), 1);
+	EXPECT_EQ(dlist_ins(NULL, n[0], n[1]), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(dlist_app(&list, list.nodes.cnt), 1);
+	EXPECT_EQ(dlist_prep(&list, list.nodes.cnt), 1);
+	EXPECT_EQ(dlist_ins(&list, n[0], n[1]), 1);
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(dlist_app(&list, n[1]), 0);
+	EXPECT_EQ(dlist_prep(&list, n[0]), 0);
+	EXPECT_EQ(dlist_app(&list, n[3]), 0);
+	EXPECT_EQ(dlist_ins(&list, n[1], n[2]), 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(dlist_app(&list, n[0]), 1);
+	EXPECT_EQ(dlist_prep(&list, n[3]), 1);
+	EXPECT_EQ(dlist_ins(&list, n[3], n[2]), 1);
+	EXPECT_EQ(dlist_ins(&list, list.nodes.cnt, n[2]), 1);
+	log_set_quiet(0, 0);
+
+	int values[4];
+	EXPECT_EQ(t_dlist_values(&list, values), 4);
+	EXPECT_EQ(values[0], 0);
+	EXPECT_EQ(values[1], 1);
+	EXPECT_EQ(values[2], 2);
+	EXPECT_EQ(values[3], 3);
+	EXPECT_EQ(list.cnt, 4);
+	EXPECT_EQ(list.head, n[0]);
+	EXPECT_EQ(list.tail, n[3]);
+
+	dlist_node_t node;
+	int *value;
+	int sum = 0;
+	dlist_foreach_rev(&list, node, value)
+	{
+		sum = sum * 10 + *value;
+	}
+	EXPECT_EQ(sum, 3210);
+
+	dlist_free(&list);
+
+	END;
+}
+
+TEST(dlist_remove)
+{
+	START;
+
+	dlist_t list = {0};
+	dlist_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	dlist_node_t n[4];
+	for (int i = 0; i < 4; i++) {
+		*(int *)dlist_node(&list, &n[i]) = i;
+		dlist_app(&list, n[i]);
+	}
+
+	EXPECT_EQ(dlist_remove(NULL, n[0]), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(dlist_remove(&list, list.nodes.cnt), 1);
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(dlist_remove(&list, n[0]), 0);
+	EXPECT_EQ(dlist_remove(&list, n[3]), 0);
+	EXPECT_EQ(dlist_remove(&list, n[1]), 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(dlist_remove(&list, n[1]), 1);
+	EXPECT_NULL(dlist_get(&list, n[1]));
+	log_set_quiet(0, 0);
+
+	int values[4];
+	EXPECT_EQ(t_dlist_values(&list, values), 1);
+	EXPECT_EQ(values[0], 2);
+	EXPECT_EQ(list.head, n[2]);
+	EXPECT_EQ(list.tail, n[2]);
+	EXPECT_EQ(list.cnt, 1);
+
+	dlist_node_t node;
+	EXPECT_NOT_NULL(dlist_node(&list, &node));
+	EXPECT_EQ(node, n[1]);
+	EXPECT_NOT_NULL(dlist_node(&list, &node));
+	EXPECT_EQ(node, n[3]);
+	EXPECT_NOT_NULL(dlist_node(&list, &node));
+	EXPECT_EQ(node, n[0]);
+	EXPECT_NOT_NULL(dlist_node(&list, &node));
+	EXPECT_EQ(node, 4);
+
+	EXPECT_EQ(dlist_remove(&list, node), 0);
+	EXPECT_EQ(list.cnt, 1);
+
+	dlist_reset(&list);
+	dlist_reset(NULL);
+	EXPECT_EQ(list.nodes.cnt, 0);
+	EXPECT_NULL(dlist_get_first(&list, &node));
+	EXPECT_EQ(node, DLIST_END);
+
+	dlist_free(&list);
+
+	END;
+}
+
+TEST(dlist_get)
+{
+	START;
+
+	dlist_t list = {0};
+	dlist_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	dlist_node_t a, b, node;
+	*(int *)dlist_node(&list, &a) = 1;
+	*(int *)dlist_node(&list, &b) = 2;
+	dlist_app(&list, a);
+	dlist_app(&list, b);
+
+	EXPECT_NULL(dlist_get(NULL, a));
+	EXPECT_NULL(dlist_get_first(NULL, NULL));
+	EXPECT_NULL(dlist_get_last(NULL, NULL));
+	EXPECT_NULL(dlist_get_next(NULL, a, NULL));
+	EXPECT_NULL(dlist_get_prev(NULL, a, NULL));
+	log_set_quiet(0, 1);
+	EXPECT_NULL(dlist_get_next(&list, list.nodes.cnt, NULL));
+	EXPECT_NULL(dlist_get_prev(&list, list.nodes.cnt, NULL));
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(*(int *)dlist_get_first(&list, &node), 1);
+	EXPECT_EQ(node, a);
+	EXPECT_EQ(*(int *)dlist_get_last(&list, &node), 2);
+	EXPECT_EQ(node, b);
+	EXPECT_EQ(*(int *)dlist_get_next(&list, a, &node), 2);
+	EXPECT_EQ(node, b);
+	EXPECT_NULL(dlist_get_next(&list, b, &node));
+	EXPECT_EQ(node, DLIST_END);
+	EXPECT_EQ(*(int *)dlist_get_prev(&list, b, &node), 1);
+	EXPECT_EQ(node, a);
+	EXPECT_NULL(dlist_get_prev(&list, a, NULL));
+
+	dlist_free(&list);
+
+	END;
+}
+
+STEST(dlist)
+{
+	SSTART;
+
+	RUN(dlist_init_free);
+	RUN(dlist_node);
+	RUN(dlist_app_prep_ins);
+	RUN(dlist_remove);
+	RUN(dlist_get);
+
+	SEND;
+}
@@ -0,0 +1,63 @@
+#include "hash.h"
+
+#include "mem.h"
+#include "test.h"
+
+TEST(hash_bytes)
+{
+	START;
+
+	byte data[256];
+	for (int i = 0; i < 256; i++) {
+		data[i] = (byte)i;
+	}
+
+	EXPECT_EQ(hash_bytes(data, 0, 0), hash_bytes(NULL, 0, 0));
+	EXPECT_EQ(hash_bytes(data, 100, 1), hash_bytes(data, 100, 1));
+	EXPECT_NE(hash_bytes(data, 100, 1), hash_bytes(data, 100, 2));
+
+	u64 hashes[257];
+	for (size_t size = 0; size <= 256; size++) {
+		hashes[size] = hash_bytes(data, size, 0);
+	}
+
+	int ok = 1;
+	for (size_t i = 0; i <= 256; i++) {
+		for (size_t j = i + 1; j <= 256; j++) {
+			ok &= hashes[i] != hashes[j];
+		}
+	}
+	EXPECT_EQ(ok, 1);
+
+	for (size_t size = 1; size <= 256; size += 7) {
+		u64 hash = hash_bytes(data, size, 0);
+		for (size_t bit = 0; bit < size * 8; bit += 5) {
+			data[bit / 8] ^= (byte)(1 << bit % 8);
+			ok &= hash_bytes(data, size, 0) != hash;
+			data[bit / 8] ^= (byte)(1 << bit % 8);
+		}
+	}
+	EXPECT_EQ(ok, 1);
+
+	END;
+}
+
+TEST(hash_seed)
+{
+	START;
+
+	EXPECT_NE(hash_seed(), 0);
+	EXPECT_EQ(hash_seed(), hash_seed());
+
+	END;
+}
+
+STEST(hash)
+{
+	SSTART;
+
+	RUN(hash_bytes);
+	RUN(hash_seed);
+
+	SEND;
+}
@@ -0,0 +1,288 @@
+#include "hmap.h"
+
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+TEST(hmap_init_free)
+{
+	START;
+
+	hmap_t map = {0};
+
+	EXPECT_NULL(hmap_init(NULL, 0, ALLOC_STD));
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_NULL(hmap_init(&map, 0, ALLOC_STD));
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_PTR(hmap_init(&map, 0, ALLOC_STD), &map);
+	EXPECT_EQ(map.cap, HMAP_GROUP);
+	hmap_free(&map);
+
+	EXPECT_PTR(hmap_init(&map, 100, ALLOC_STD), &map);
+	EXPECT_EQ(map.cap, 128);
+	EXPECT_EQ(map.cnt, 0);
+
+	hmap_free(&map);
+	hmap_free(&map);
+	hmap_free(NULL);
+
+	EXPECT_NULL(map.ctrl);
+	EXPECT_EQ(map.cap, 0);
+
+	END;
+}
+
+TEST(hmap_set_get)
+{
+	START;
+
+	hmap_t map = {0};
+	hmap_init(&map, 0, ALLOC_STD);
+
+	int a = 1, b = 2;
+	void *value;
+
+	EXPECT_EQ(hmap_set(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(hmap_set(&map, NULL, 0, NULL), 1);
+	EXPECT_EQ(hmap_get(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(hmap_get(&map, NULL, 0, NULL), 1);
+
+	EXPECT_EQ(hmap_get(&map, "a", 1, &value), 1);
+	EXPECT_EQ(hmap_set(&map, "a", 1, &a), 0);
+	EXPECT_EQ(hmap_get(&map, "a", 1, NULL), 0);
+	EXPECT_EQ(hmap_get(&map, "a", 1, &value), 0);
+	EXPECT_PTR(value, &a);
+	EXPECT_EQ(hmap_set(&map, "a", 1, &b), 0);
+	EXPECT_EQ(hmap_get(&map, "a", 1, &value), 0);
+	EXPECT_PTR(value, &b);
+	EXPECT_EQ(map.cnt, 1);
+
+	EXPECT_EQ(hmap_get(&map, "ab", 2, NULL), 1);
+	EXPECT_EQ(hmap_get(&map, "", 0, NULL), 1);
+	EXPECT_EQ(hmap_set(&map, "", 0, &a), 0);
+	EXPECT_EQ(hmap_get(&map, "", 0, &value), 0);
+	EXPECT_PTR(value, &a);
+
+	EXPECT_EQ(hmap_set(&map, "abcde", 5, &a), 0);
+	EXPECT_EQ(hmap_set(&map, "abcdefghijklmnop", 16, &b), 0);
+	EXPECT_EQ(hmap_get(&map, "abcdX", 5, NULL), 1);
+	EXPECT_EQ(hmap_get(&map, "abcdefghiXklmnop", 16, NULL), 1);
+	EXPECT_EQ(hmap_get(&map, "abcdefghijklmnoX", 16, NULL), 1);
+	EXPECT_EQ(hmap_get(&map, "abcdefghijklmnop", 16, &value), 0);
+	EXPECT_PTR(value, &b);
+
+	const char *lng = "a key that is longer than the inline size";
+	EXPECT_EQ(hmap_set(&map, lng, 41, &a), 0);
+	EXPECT_EQ(hmap_get(&map, "a key that is longer than the inline size", 41, &value), 0);
+	EXPECT_PTR(value, &a);
+
+	hmap_free(&map);
+
+	END;
+}
+
+static u64 t_hmap_hash_cb(const void *key, size_t ksize, const void *priv)
+{
+	(void)priv;
+	u64 hash = 0;
+	for (size_t i = 0; i < ksize; i++) {
+		hash = hash * 31 + (((const char *)key)[i] | 0x20);
+	}
+	return hash * 0x9e3779b97f4a7c15ULL;
+}
+
+static int t_hmap_eq_cb(const void *key1, size_t ksize1, const void *key2, size_t ksize2, const void *priv)
+{
+	(void)priv;
+	if (ksize1 != ksize2) {
+		return 0;
+	}
+	for (size_t i = 0; i < ksize1; i++) {
+		if ((((const char *)key1)[i] | 0x20) != (((const char *)key2)[i] | 0x20)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+TEST(hmap_set_hash)
+{
+	START;
+
+	hmap_t map = {0};
+	hmap_init(&map, 0, ALLOC_STD);
+
+	EXPECT_EQ(hmap_set_hash(NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(hmap_set_hash(&map, t_hmap_hash_cb, t_hmap_eq_cb, NULL), 0);
+
+	int a = 1, b = 2;
+	EXPECT_EQ(hmap_set(&map, "One", 3, &a), 0);
+	EXPECT_EQ(hmap_set(&map, "a key longer than inline", 24, &b), 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(hmap_set_hash(&map, NULL, NULL, NULL), 1);
+	log_set_quiet(0, 0);
+
+	void *value;
+	EXPECT_EQ(hmap_get(&map, "oNE", 3, &value), 0);
+	EXPECT_PTR(value, &a);
+	EXPECT_EQ(hmap_get(&map, "A KEY LONGER THAN INLINE", 24, &value), 0);
+	EXPECT_PTR(value, &b);
+	EXPECT_EQ(hmap_remove(&map, "ONE", 3, NULL), 0);
+	EXPECT_EQ(map.cnt, 1);
+
+	hmap_free(&map);
+
+	END;
+}
+
+TEST(hmap_grow)
+{
+	START;
+
+	hmap_t map = {0};
+	hmap_init(&map, 0, ALLOC_STD);
+
+	int ok = 1;
+	for (uint i = 0; i < 10000; i++) {
+		ok &= hmap_set(&map, &i, sizeof(i), (void *)(size_t)i) == 0;
+	}
+	EXPECT_EQ(ok, 1);
+	EXPECT_EQ(map.cnt, 10000);
+
+	for (uint i = 0; i < 10000; i++) {
+		void *value = NULL;
+		ok &= hmap_get(&map, &i, sizeof(i), &value) == 0 && (size_t)value == i;
+	}
+	EXPECT_EQ(ok, 1);
+
+	uint i = 10000;
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	for (; map.left > 0 && i < 20000; i++) {
+		hmap_set(&map, &i, sizeof(i), NULL);
+	}
+	EXPECT_EQ(hmap_set(&map, &i, sizeof(i), NULL), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(hmap_set(&map, &i, sizeof(i), NULL), 0);
+	EXPECT_EQ(hmap_get(&map, &i, sizeof(i), NULL), 0);
+
+	hmap_free(&map);
+
+	END;
+}
+
+TEST(hmap_remove)
+{
+	START;
+
+	hmap_t map = {0};
+	hmap_init(&map, 0, ALLOC_STD);
+
+	void *value;
+	EXPECT_EQ(hmap_remove(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(hmap_remove(&map, NULL, 0, NULL), 1);
+	EXPECT_EQ(hmap_remove(&map, "a", 1, NULL), 1);
+
+	int ok = 1;
+	for (uint i = 0; i < 1000; i++) {
+		ok &= hmap_set(&map, &i, sizeof(i), (void *)(size_t)i) == 0;
+	}
+
+	for (uint i = 0; i < 1000; i += 2) {
+		ok &= hmap_remove(&map, &i, sizeof(i), &value) == 0 && (size_t)value == i;
+	}
+	EXPECT_EQ(ok, 1);
+	EXPECT_EQ(map.cnt, 500);
+
+	for (uint i = 0; i < 1000; i++) {
+		ok &= hmap_get(&map, &i, sizeof(i), NULL) == (int)(i % 2 == 0);
+	}
+	EXPECT_EQ(ok, 1);
+
+	uint cap = map.cap;
+	for (uint round = 0; round < 20; round++) {
+		for (uint i = 0; i < 1000; i += 2) {
+			ok &= hmap_set(&map, &i, sizeof(i), NULL) == 0;
+		}
+		for (uint i = 0; i < 1000; i += 2) {
+			ok &= hmap_remove(&map, &i, sizeof(i), NULL) == 0;
+		}
+	}
+	EXPECT_EQ(ok, 1);
+	EXPECT_EQ(map.cnt, 500);
+	EXPECT_EQ(map.cap, cap);
+
+	hmap_free(&map);
+
+	END;
+}
+
+TEST(hmap_reset)
+{
+	START;
+
+	hmap_t map = {0};
+	hmap_init(&map, 0, ALLOC_STD);
+
+	hmap_set(&map, "a", 1, NULL);
+
+	hmap_reset(NULL);
+	hmap_reset(&map);
+
+	EXPECT_EQ(map.cnt, 0);
+	EXPECT_EQ(hmap_get(&map, "a", 1, NULL), 1);
+
+	hmap_free(&map);
+
+	END;
+}
+
+TEST(hmap_foreach)
+{
+	START;
+
+	hmap_t map = {0};
+	hmap_init(&map, 0, ALLOC_STD);
+
+	for (uint i = 0; i < 100; i++) {
+		hmap_set(&map, &i, sizeof(i), (void *)(size_t)i);
+	}
+
+	EXPECT_NULL(hmap_next(NULL, NULL));
+	EXPECT_NULL(hmap_key(NULL));
+
+	hmap_slot_t *slot;
+	uint i	 = 0;
+	uint cnt = 0;
+	int ok	 = 1;
+	hmap_foreach(&map, i, slot)
+	{
+		ok &= *(const uint *)hmap_key(slot) == (size_t)slot->value;
+		cnt++;
+	}
+	EXPECT_EQ(ok, 1);
+	EXPECT_EQ(cnt, 100);
+
+	hmap_free(&map);
+
+	END;
+}
+
+STEST(hmap)
+{
+	SSTART;
+
+	RUN(hmap_init_free);
+	RUN(hmap_set_get);
+	RUN(hmap_set_hash);
+	RUN(hmap_grow);
+	RUN(hmap_remove);
+	RUN(hmap_reset);
+	RUN(hmap_foreach);
+
+	SEND;
+}
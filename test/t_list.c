@@ -16,18 +16,18 @@ TEST(list_init_free)
 	mem_oom(0);
 	EXPECT_PTR(list_init(&list, 1, sizeof(int), ALLOC_STD), &list);
 
-	EXPECT_NOT_NULL(list.data);
-	EXPECT_EQ(list.cap, 1);
-	EXPECT_EQ(list.cnt, 0);
-	EXPECT_NE(list.size, 0);
+	EXPECT_NOT_NULL(list.nodes.data);
+	EXPECT_EQ(list.nodes.cap, 1);
+	EXPECT_EQ(list.nodes.cnt, 0);
+	EXPECT_NE(list.nodes.size, 0);
 
 	list_free(&list);
 	list_free(NULL);
 
-	EXPECT_NULL(list.data);
-	EXPECT_EQ(list.cap, 0);
-	EXPECT_EQ(list.cnt, 0);
-	EXPECT_EQ(list.size, 0);
+	EXPECT_NULL(list.nodes.data);
+	EXPECT_EQ(list.nodes.cap, 0);
+	EXPECT_EQ(list.nodes.cnt, 0);
+	EXPECT_EQ(list.nodes.size, 0);
 
 	END;
 }
@@ -58,7 +58,7 @@ TEST(list_reset)
 	EXPECT_EQ(*data, 10);
 
 	list_reset(&list, 2);
-	EXPECT_EQ(list.cnt, 1);
+	EXPECT_EQ(list.nodes.cnt, 1);
 
 	list_free(&list);
 
@@ -83,8 +83,8 @@ TEST(list_node)
 	EXPECT_NOT_NULL(list_node(&list, &node));
 
 	EXPECT_EQ(node, 0);
-	EXPECT_EQ(list.cnt, 1);
-	EXPECT_EQ(list.cap, 1);
+	EXPECT_EQ(list.nodes.cnt, 1);
+	EXPECT_EQ(list.nodes.cap, 1);
 
 	list_free(&list);
 
@@ -105,8 +105,8 @@ TEST(list_nodes)
 	EXPECT_NOT_NULL(list_node(&list, &node));
 	EXPECT_EQ(node, 1);
 
-	EXPECT_EQ(list.cnt, 2);
-	EXPECT_EQ(list.cap, 2);
+	EXPECT_EQ(list.nodes.cnt, 2);
+	EXPECT_EQ(list.nodes.cap, 2);
 
 	list_free(&list);
 
@@ -123,16 +123,16 @@ TEST(list_app)
 	list_node_t root, node;
 	list_node(&list, &root);
 
-	EXPECT_EQ(list_app(NULL, list.cnt, list.cnt), 1);
+	EXPECT_EQ(list_app(NULL, list.nodes.cnt, list.nodes.cnt), 1);
 	log_set_quiet(0, 1);
-	EXPECT_EQ(list_app(&list, list.cnt, list.cnt), 1);
-	EXPECT_EQ(list_app(&list, root, list.cnt), 1);
+	EXPECT_EQ(list_app(&list, list.nodes.cnt, list.nodes.cnt), 1);
+	EXPECT_EQ(list_app(&list, root, list.nodes.cnt), 1);
 	log_set_quiet(0, 0);
 	list_node(&list, &node);
 	EXPECT_EQ(list_app(&list, root, node), 0);
 
-	EXPECT_EQ(list.cnt, 2);
-	EXPECT_EQ(list.cap, 2);
+	EXPECT_EQ(list.nodes.cnt, 2);
+	EXPECT_EQ(list.nodes.cap, 2);
 
 	list_free(&list);
 
@@ -167,6 +167,71 @@ TEST(list_app_loop)
 	END;
 }
 
+TEST(list_app_n)
+{
+	START;
+
+	list_t list = {0};
+	list_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	list_node_t root, nodes[4];
+	*(int *)list_node(&list, &root) = 0;
+	for (int i = 0; i < 4; i++) {
+		*(int *)list_node(&list, &nodes[i]) = i + 1;
+	}
+
+	list_app(&list, nodes[2], nodes[3]);
+
+	EXPECT_EQ(list_app_n(NULL, root, nodes, 3), 1);
+	EXPECT_EQ(list_app_n(&list, root, NULL, 3), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_app_n(&list, list.nodes.cnt, nodes, 3), 1);
+	nodes[1] = list.nodes.cnt;
+	EXPECT_EQ(list_app_n(&list, root, nodes, 3), 1);
+	log_set_quiet(0, 0);
+	nodes[1] = 2;
+
+	EXPECT_EQ(list_app_n(&list, root, nodes, 0), 0);
+	EXPECT_EQ(list_app_n(&list, root, nodes, 3), 0);
+
+	int *value;
+	list_node_t node = root;
+	int sum		 = 0;
+	list_foreach(&list, node, value)
+	{
+		sum = sum * 10 + *value;
+	}
+	EXPECT_EQ(sum, 1234);
+
+	list_node_t a, b, c;
+	list_node(&list, &a);
+	list_node(&list, &b);
+	list_node(&list, &c);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_app_n(&list, a, (list_node_t[]){b, c, b}, 3), 1);
+	EXPECT_EQ(list_app_n(&list, a, (list_node_t[]){b, a}, 2), 1);
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(list_get_next(&list, a, NULL), NULL);
+	EXPECT_EQ(list_get_next(&list, b, NULL), NULL);
+	EXPECT_EQ(*(int *)list_get_at(&list, root, 4, NULL), 4);
+
+	EXPECT_EQ(list_app_n(&list, a, (list_node_t[]){b, c}, 2), 0);
+	EXPECT_EQ(list_app_n(&list, root, (list_node_t[]){a}, 1), 0);
+	EXPECT_PTR(list_get_at(&list, root, 7, &node), list_get(&list, c));
+	EXPECT_EQ(node, c);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_app_n(&list, root, (list_node_t[]){c}, 1), 1);
+	log_set_quiet(0, 0);
+	EXPECT_EQ(list_get_next(&list, c, NULL), NULL);
+
+	list_free(&list);
+
+	END;
+}
+
 TEST(list_remove)
 {
 	START;
@@ -177,13 +242,13 @@ TEST(list_remove)
 	list_node_t node;
 	list_node(&list, &node);
 
-	EXPECT_EQ(list_remove(NULL, list.cnt), 1);
+	EXPECT_EQ(list_remove(NULL, list.nodes.cnt), 1);
 	log_set_quiet(0, 1);
-	EXPECT_EQ(list_remove(&list, list.cnt), 1);
+	EXPECT_EQ(list_remove(&list, list.nodes.cnt), 1);
 	log_set_quiet(0, 0);
 	EXPECT_EQ(list_remove(&list, node), 0);
 
-	EXPECT_EQ(list.cnt, 1);
+	EXPECT_EQ(list.nodes.cnt, 1);
 
 	list_free(&list);
 
@@ -240,6 +305,166 @@ TEST(list_remove_last)
 	END;
 }
 
+TEST(list_delete)
+{
+	START;
+
+	list_t list = {0};
+	list_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	list_node_t root, n1, n2, node;
+	*(int *)list_node(&list, &root) = 0;
+	*(int *)list_node(&list, &n1)	= 1;
+	*(int *)list_node(&list, &n2)	= 2;
+	list_app(&list, root, n1);
+	list_app(&list, root, n2);
+
+	EXPECT_EQ(list_delete(NULL, n1), 1);
+	EXPECT_EQ(list_release(NULL, n1), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_release(&list, list.nodes.cnt), 1);
+	log_set_quiet(0, 0);
+	EXPECT_EQ(list_delete(&list, n1), 0);
+	EXPECT_EQ(list.freed, 1);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_delete(&list, n1), 1);
+	EXPECT_EQ(list_release(&list, n1), 1);
+	EXPECT_NULL(list_get(&list, n1));
+	log_set_quiet(0, 0);
+	EXPECT_NULL(list_get_next(&list, n1, NULL));
+
+	EXPECT_NOT_NULL(list_get_next(&list, root, &node));
+	EXPECT_EQ(node, n2);
+
+	int *value;
+	list_node_t i = 0;
+	int sum	      = 0;
+	list_foreach_all(&list, i, value)
+	{
+		sum += *value;
+	}
+	EXPECT_EQ(sum, 2);
+
+	EXPECT_NOT_NULL(list_node(&list, &node));
+	EXPECT_EQ(node, n1);
+	EXPECT_EQ(list.freed, 0);
+	EXPECT_EQ(list.nodes.cnt, 3);
+
+	list_free(&list);
+
+	END;
+}
+
+TEST(list_compact)
+{
+	START;
+
+	list_t list = {0};
+	list_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	list_node_t n[5];
+	*(int *)list_node(&list, &n[0]) = 0;
+	for (int i = 1; i < 5; i++) {
+		*(int *)list_node(&list, &n[i]) = i;
+		list_app(&list, n[0], n[i]);
+	}
+
+	list_delete(&list, n[0]);
+	list_delete(&list, n[2]);
+
+	list_node_t remap[5];
+	EXPECT_EQ(list_compact(NULL, NULL), 1);
+	EXPECT_EQ(list_compact(&list, remap), 0);
+
+	EXPECT_EQ(list.nodes.cnt, 3);
+	EXPECT_EQ(list.freed, 0);
+	EXPECT_EQ(remap[0], (list_node_t)-1);
+	EXPECT_EQ(remap[1], 0);
+	EXPECT_EQ(remap[2], (list_node_t)-1);
+	EXPECT_EQ(remap[3], 1);
+	EXPECT_EQ(remap[4], 2);
+
+	int *value;
+	list_node_t node = remap[1];
+	int sum		 = 0;
+	list_foreach(&list, node, value)
+	{
+		sum = sum * 10 + *value;
+	}
+	EXPECT_EQ(sum, 134);
+
+	list_delete(&list, 1);
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_compact(&list, NULL), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(list_compact(&list, NULL), 0);
+	EXPECT_EQ(list.nodes.cnt, 2);
+	EXPECT_EQ(*(int *)list_get_next(&list, 0, NULL), 4);
+
+	list_reset(&list, 0);
+	EXPECT_EQ(list_compact(&list, NULL), 0);
+
+	list_free(&list);
+
+	END;
+}
+
+TEST(list_remap)
+{
+	START;
+
+	list_t list = {0};
+	list_init(&list, 1, sizeof(int), ALLOC_STD);
+
+	list_node_t n[3];
+	*(int *)list_node(&list, &n[0]) = 0;
+	*(int *)list_node(&list, &n[1]) = 1;
+	*(int *)list_node(&list, &n[2]) = 2;
+	list_app(&list, n[0], n[1]);
+
+	list_node_t remap[3] = {2, 0, 1};
+
+	EXPECT_EQ(list_remap(NULL, remap), 1);
+	EXPECT_EQ(list_remap(&list, NULL), 1);
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_remap(&list, remap), 1);
+	mem_oom(0);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(list_remap(&list, (list_node_t[]){2, 2, 1}), 1);
+	EXPECT_EQ(list_remap(&list, (list_node_t[]){3, 0, 1}), 1);
+	EXPECT_EQ(list_remap(&list, (list_node_t[]){2, (list_node_t)-1, 0}), 1);
+	log_set_quiet(0, 0);
+	EXPECT_EQ(*(int *)list_get(&list, 0), 0);
+	EXPECT_EQ(list.nodes.cnt, 3);
+	EXPECT_EQ(list_remap(&list, remap), 0);
+
+	list_node_t node;
+	EXPECT_EQ(*(int *)list_get(&list, 2), 0);
+	EXPECT_EQ(*(int *)list_get_next(&list, 2, &node), 1);
+	EXPECT_EQ(node, 0);
+	EXPECT_EQ(*(int *)list_get(&list, 1), 2);
+
+	remap[0] = (list_node_t)-1;
+	remap[1] = 1;
+	remap[2] = 0;
+	EXPECT_EQ(list_remap(&list, remap), 0);
+	EXPECT_EQ(list.nodes.cnt, 2);
+	EXPECT_EQ(*(int *)list_get(&list, 0), 0);
+	EXPECT_NULL(list_get_next(&list, 0, &node));
+	EXPECT_EQ(node, (list_node_t)-1);
+
+	list_reset(&list, 0);
+	EXPECT_EQ(list_remap(&list, remap), 0);
+
+	list_free(&list);
+
+	END;
+}
+
 TEST(list_get)
 {
 	START;
@@ -250,14 +475,14 @@ TEST(list_get)
 	list_node_t node;
 	list_node(&list, &node);
 
-	EXPECT_NULL(list_get(NULL, list.cnt));
+	EXPECT_NULL(list_get(NULL, list.nodes.cnt));
 	log_set_quiet(0, 1);
-	EXPECT_NULL(list_get(&list, list.cnt));
+	EXPECT_NULL(list_get(&list, list.nodes.cnt));
 	log_set_quiet(0, 0);
 	*(int *)list_get(&list, node) = 8;
 
-	EXPECT_EQ(list.cnt, 1);
-	EXPECT_EQ(list.cap, 1);
+	EXPECT_EQ(list.nodes.cnt, 1);
+	EXPECT_EQ(list.nodes.cap, 1);
 	EXPECT_EQ(*(int *)list_get(&list, node), 8);
 
 	list_free(&list);
@@ -277,14 +502,14 @@ TEST(list_get_next)
 	list_node(&list, &next);
 	list_app(&list, root, next);
 
-	uint cnt = list.cnt;
+	uint cnt = list.nodes.cnt;
 
-	EXPECT_NULL(list_get_next(NULL, list.cnt, NULL));
+	EXPECT_NULL(list_get_next(NULL, list.nodes.cnt, NULL));
 	log_set_quiet(0, 1);
-	EXPECT_NULL(list_get_next(&list, list.cnt, NULL));
-	list.cnt--;
+	EXPECT_NULL(list_get_next(&list, list.nodes.cnt, NULL));
+	list.nodes.cnt--;
 	EXPECT_NULL(list_get_next(&list, root, &node));
-	list.cnt = cnt;
+	list.nodes.cnt = cnt;
 	log_set_quiet(0, 0);
 	EXPECT_NOT_NULL(list_get_next(&list, root, &node));
 	EXPECT_EQ(node, next);
@@ -329,9 +554,9 @@ TEST(list_get_at)
 	list_app(&list, root, n1);
 	list_app(&list, root, n2);
 
-	EXPECT_NULL(list_get_at(NULL, list.cnt, list.cnt, NULL));
+	EXPECT_NULL(list_get_at(NULL, list.nodes.cnt, list.nodes.cnt, NULL));
 	log_set_quiet(0, 1);
-	EXPECT_NULL(list_get_at(&list, list.cnt, list.cnt, NULL));
+	EXPECT_NULL(list_get_at(&list, list.nodes.cnt, list.nodes.cnt, NULL));
 	log_set_quiet(0, 0);
 	EXPECT_EQ(*(int *)list_get_at(&list, root, 0, &node), 1);
 	EXPECT_EQ(node, root);
@@ -433,8 +658,8 @@ TEST(list_print)
 	list_app(&list, node, n2);
 
 	char buf[16] = {0};
-	EXPECT_EQ(list_print(NULL, list.cnt, NULL, DST_BUF(buf), NULL), 0);
-	EXPECT_EQ(list_print(&list, list.cnt, NULL, DST_BUF(buf), NULL), 0);
+	EXPECT_EQ(list_print(NULL, list.nodes.cnt, NULL, DST_BUF(buf), NULL), 0);
+	EXPECT_EQ(list_print(&list, list.nodes.cnt, NULL, DST_BUF(buf), NULL), 0);
 	EXPECT_EQ(list_print(&list, node, NULL, DST_BUF(buf), NULL), 0);
 
 	EXPECT_EQ(list_print(&list, node, print_list, DST_BUF(buf), NULL), 6);
@@ -487,9 +712,13 @@ STEST(list)
 	RUN(list_nodes);
 	RUN(list_app);
 	RUN(list_app_loop);
+	RUN(list_app_n);
 	RUN(list_remove);
 	RUN(list_remove_middle);
 	RUN(list_remove_last);
+	RUN(list_delete);
+	RUN(list_compact);
+	RUN(list_remap);
 	RUN(list_get);
 	RUN(list_get_next);
 	RUN(list_get_next_loop);
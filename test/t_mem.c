@@ -3,6 +3,8 @@
 #include "log.h"
 #include "test.h"
 
+#include <string.h>
+
 TEST(mem_print)
 {
 	START;
@@ -202,6 +204,91 @@ TEST(mem_swap)
 	END;
 }
 
+TEST(mem_swap_sizes)
+{
+	START;
+
+	byte a[300];
+	byte b[300];
+
+	for (size_t size = 1; size < sizeof(a); size += 7) {
+		for (size_t i = 0; i < size; i++) {
+			a[i] = (byte)i;
+			b[i] = (byte)(i + 1);
+		}
+
+		EXPECT_EQ(mem_swap(a, b, size), 0);
+
+		int ok = 1;
+		for (size_t i = 0; i < size; i++) {
+			ok &= a[i] == (byte)(i + 1) && b[i] == (byte)i;
+		}
+		EXPECT_EQ(ok, 1);
+	}
+
+	END;
+}
+
+TEST(mem_eq)
+{
+	START;
+
+	char l[] = "abcdefghijklmnopqrstuvwxyz";
+	char r[] = "abcdefghijklmnopqrstuvwxyz";
+
+	EXPECT_EQ(mem_eq(NULL, NULL, 0), 1);
+	EXPECT_EQ(mem_eq(l, NULL, 0), 0);
+	EXPECT_EQ(mem_eq(l, r, 0), 1);
+
+	for (size_t size = 1; size < sizeof(l); size++) {
+		EXPECT_EQ(mem_eq(l, r, size), 1);
+		r[size - 1] = '_';
+		EXPECT_EQ(mem_eq(l, r, size), 0);
+		r[size - 1] = l[size - 1];
+	}
+
+	END;
+}
+
+TEST(mem_find)
+{
+	START;
+
+	const char str[] = "abcabd";
+
+	EXPECT_NULL(mem_find(NULL, 0, NULL, 0));
+	EXPECT_NULL(mem_find(str, 6, NULL, 0));
+	EXPECT_NULL(mem_find(str, 6, "a", 0));
+	EXPECT_NULL(mem_find(str, 1, "ab", 2));
+	EXPECT_PTR(mem_find(str, 6, "c", 1), str + 2);
+	EXPECT_PTR(mem_find(str, 6, "abd", 3), str + 3);
+	EXPECT_PTR(mem_find(str, 6, "ab", 2), str);
+	EXPECT_NULL(mem_find(str, 6, "x", 1));
+	EXPECT_NULL(mem_find(str, 6, "abe", 3));
+	EXPECT_NULL(mem_find(str, 5, "abd", 3));
+
+	END;
+}
+
+TEST(mem_fill)
+{
+	START;
+
+	char buf[12] = {0};
+
+	EXPECT_NULL(mem_fill(NULL, 0, NULL, 0));
+	EXPECT_NULL(mem_fill(buf, 0, NULL, 0));
+	EXPECT_NULL(mem_fill(buf, 0, "a", 0));
+	EXPECT_PTR(mem_fill(buf, 3, "a", 1), buf);
+	EXPECT_STR(buf, "aaa");
+	EXPECT_PTR(mem_fill(buf, 11, "abc", 3), buf);
+	EXPECT_STR(buf, "abcabcabcab");
+	EXPECT_PTR(mem_fill(buf, 2, "xyz", 3), buf);
+	EXPECT_STR(buf, "xycabcabcab");
+
+	END;
+}
+
 TEST(mem_oom)
 {
 	START;
@@ -212,6 +299,242 @@ TEST(mem_oom)
 	END;
 }
 
+TEST(mem_tcache)
+{
+	START;
+
+	const mem_stats_t *stats = mem_stats_get();
+
+	size_t m = stats->mem;
+
+	mem_tcache_flush();
+	EXPECT_EQ(mem_tcache(0), 0);
+
+	void *ptr = mem_alloc(24);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(mem_tcache(1), 1);
+	log_set_quiet(0, 0);
+	mem_free(ptr, 24);
+
+	EXPECT_EQ(mem_tcache(1), 0);
+	EXPECT_EQ(mem_tcache(1), 0);
+
+	ptr = mem_alloc(24);
+	EXPECT_NOT_NULL(ptr);
+	mem_free(ptr, 24);
+	EXPECT_PTR(mem_alloc(20), ptr);
+
+	void *prev = ptr;
+	EXPECT_PTR(ptr = mem_realloc(ptr, 32, 20), prev);
+	EXPECT_NOT_NULL(ptr = mem_realloc(ptr, 1024, 32));
+	EXPECT_NOT_NULL(ptr = mem_realloc(ptr, 16, 1024));
+	mem_free(ptr, 16);
+
+	byte *data = mem_calloc(4, sizeof(int));
+	EXPECT_NOT_NULL(data);
+	EXPECT_EQ(data[0] | data[15], 0);
+	mem_free(data, 4 * sizeof(int));
+
+	data = mem_calloc(1024, 1);
+	EXPECT_NOT_NULL(data);
+	mem_free(data, 1024);
+
+	void *ptrs[128];
+	for (int i = 0; i < 128; i++) {
+		ptrs[i] = mem_alloc(64);
+	}
+	for (int i = 0; i < 128; i++) {
+		mem_free(ptrs[i], 64);
+	}
+	for (int i = 0; i < 128; i++) {
+		ptrs[i] = mem_alloc(64);
+	}
+	for (int i = 0; i < 128; i++) {
+		mem_free(ptrs[i], 64);
+	}
+
+	EXPECT_EQ(mem_check(), 0);
+	EXPECT_EQ(stats->mem, m);
+
+	mem_tcache_flush();
+	mem_tcache(0);
+
+	END;
+}
+
+TEST(mem_shards)
+{
+	START;
+
+	const mem_stats_t *stats = mem_stats_get();
+
+	size_t m      = stats->mem;
+	size_t allocs = stats->allocs;
+
+	mem_shards(1);
+
+	void *ptr = mem_alloc(16);
+	EXPECT_NOT_NULL(ptr = mem_realloc(ptr, 32, 16));
+
+	EXPECT_EQ(stats->allocs, allocs);
+	mem_merge();
+	EXPECT_EQ(stats->allocs, allocs + 1);
+	EXPECT_EQ(stats->mem, m + 32);
+
+	mem_free(ptr, 32);
+
+	EXPECT_EQ(mem_check(), 0);
+	EXPECT_EQ(stats->mem, m);
+
+	mem_shards(0);
+
+	END;
+}
+
+TEST(mem_tags)
+{
+	START;
+
+	void *ptr = mem_alloc(16);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(mem_tags(1), 1);
+	log_set_quiet(0, 0);
+	mem_free(ptr, 16);
+
+	EXPECT_EQ(mem_tags(1), 0);
+	EXPECT_EQ(mem_tags(1), 0);
+
+	ptr = mem_alloc(16);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(mem_tags(0), 1);
+	log_set_quiet(0, 0);
+	EXPECT_NOT_NULL(ptr = mem_realloc(ptr, 64, 16));
+	mem_free(ptr, 64);
+
+	byte *data = mem_calloc(4, sizeof(int));
+	EXPECT_NOT_NULL(data);
+	EXPECT_EQ(data[0] | data[15], 0);
+	mem_free(data, 4 * sizeof(int));
+
+	EXPECT_EQ(mem_tcache(1), 0);
+	ptr = mem_alloc(16);
+	EXPECT_NOT_NULL(ptr = mem_realloc(ptr, 512, 16));
+	EXPECT_NOT_NULL(ptr = mem_realloc(ptr, 4096, 512));
+	mem_free(ptr, 4096);
+	mem_tcache_flush();
+	EXPECT_EQ(mem_tcache(0), 0);
+
+	EXPECT_EQ(mem_check(), 0);
+	EXPECT_EQ(mem_tags(0), 0);
+
+	END;
+}
+
+TEST(mem_tag)
+{
+	START;
+
+	mem_tags(1);
+	mem_tags_reset();
+
+	static const char *ta = "t_mem_a";
+	static const char *tb = "t_mem_b";
+
+	mem_tag_stats_t a0, b0, st;
+	mem_tag_get(ta, &a0);
+	mem_tag_get(tb, &b0);
+
+	EXPECT_NULL(mem_tag(ta));
+
+	void *a = mem_alloc(16);
+	EXPECT_NOT_NULL(a = mem_realloc(a, 64, 16));
+
+	EXPECT_STR(mem_tag(tb), ta);
+
+	void *b = mem_alloc(256);
+	void *c = mem_alloc(32);
+	mem_free(c, 32);
+
+	EXPECT_EQ(mem_tag_get(ta, &st), 0);
+	EXPECT_EQ(st.live, a0.live + 64);
+
+	// a is freed under another tag and b under none, both are charged to the tag they were allocated under
+	mem_free(a, 64);
+
+	EXPECT_STR(mem_tag(NULL), tb);
+
+	EXPECT_EQ(mem_tag_get(tb, &st), 0);
+	EXPECT_EQ(st.live, b0.live + 256);
+	EXPECT_EQ(st.peak, b0.peak + 288);
+
+	mem_free(b, 256);
+
+	EXPECT_EQ(mem_tag_get(ta, &st), 0);
+	EXPECT_EQ(st.allocs, a0.allocs + 1);
+	EXPECT_EQ(st.reallocs, a0.reallocs + 1);
+	EXPECT_EQ(st.live, a0.live);
+	EXPECT_EQ(st.peak, a0.peak + 64);
+	EXPECT_EQ(st.bytes, a0.bytes + 64);
+
+	EXPECT_EQ(mem_tag_get(tb, &st), 0);
+	EXPECT_EQ(st.allocs, b0.allocs + 2);
+	EXPECT_EQ(st.reallocs, b0.reallocs);
+	EXPECT_EQ(st.live, b0.live);
+	EXPECT_EQ(st.peak, b0.peak + 288);
+	EXPECT_EQ(st.bytes, b0.bytes + 288);
+
+	char buf[512] = {0};
+	EXPECT_GT(mem_print_tags(DST_BUF(buf)), 0);
+	EXPECT_STR(buf,
+		   "memory tags:\n"
+		   "    t_mem_b          allocs: 2        reallocs: 0        live: 0        peak: 288      bytes: 288 B\n"
+		   "    t_mem_a          allocs: 1        reallocs: 1        live: 0        peak: 64       bytes: 64 B\n");
+
+	mem_shards(1);
+	mem_tag(ta);
+	a = mem_alloc(128);
+	mem_tag(tb);
+	mem_free(a, 128);
+	mem_tag(NULL);
+	mem_shards(0);
+
+	EXPECT_EQ(mem_tag_get(ta, &st), 0);
+	EXPECT_EQ(st.allocs, a0.allocs + 2);
+	EXPECT_EQ(st.live, a0.live);
+	EXPECT_EQ(mem_tag_get(tb, &st), 0);
+	EXPECT_EQ(st.live, b0.live);
+
+	mem_tag(ta);
+	a = mem_alloc(8);
+	mem_tag(NULL);
+	mem_tags_reset();
+	EXPECT_EQ(mem_tag_get(ta, &st), 1);
+	mem_free(a, 8);
+	EXPECT_EQ(mem_tag_get(ta, &st), 1);
+
+	static char tags[33][8];
+	for (int i = 0; i < 33; i++) {
+		tags[i][0] = 't';
+		tags[i][1] = (char)('0' + i / 10);
+		tags[i][2] = (char)('0' + i % 10);
+		mem_tag(tags[i]);
+		mem_free(mem_alloc(1), 1);
+	}
+	for (int i = 0; i < 3; i++) {
+		mem_free(mem_alloc(1), 1);
+	}
+	mem_tag(NULL);
+
+	char big[4096] = {0};
+	EXPECT_GT(mem_print_tags(DST_BUF(big)), 0);
+	EXPECT_NOT_NULL(strstr(big, "    4 tagged allocations not tracked: more than 32 tags\n"));
+
+	mem_tags_reset();
+	EXPECT_EQ(mem_tags(0), 0);
+
+	END;
+}
+
 STEST(mem)
 {
 	SSTART;
@@ -231,7 +554,15 @@ STEST(mem)
 	RUN(mem_replace);
 	RUN(mem_cmp);
 	RUN(mem_swap);
+	RUN(mem_swap_sizes);
+	RUN(mem_eq);
+	RUN(mem_find);
+	RUN(mem_fill);
 	RUN(mem_oom);
+	RUN(mem_tcache);
+	RUN(mem_shards);
+	RUN(mem_tags);
+	RUN(mem_tag);
 
 	mem_stats_set((mem_stats_t *)mem);
 
@@ -0,0 +1,294 @@
+#include "odict.h"
+
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+TEST(odict_init_free)
+{
+	START;
+
+	odict_t map = {0};
+
+	EXPECT_NULL(odict_init(NULL, 0, ALLOC_STD));
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_NULL(odict_init(&map, 0, ALLOC_STD));
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_PTR(odict_init(&map, 0, ALLOC_STD), &map);
+	EXPECT_EQ(map.cap, 8);
+	EXPECT_EQ(map.icap, 16);
+
+	odict_free(&map);
+	odict_free(&map);
+	odict_free(NULL);
+
+	EXPECT_NULL(map.entries);
+	EXPECT_NULL(map.index);
+
+	END;
+}
+
+TEST(odict_set_get_remove)
+{
+	START;
+
+	odict_t map = {0};
+	odict_init(&map, 0, ALLOC_STD);
+
+	int a = 1, b = 2;
+	void *value;
+
+	EXPECT_EQ(odict_set(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(odict_set(&map, NULL, 0, NULL), 1);
+	EXPECT_EQ(odict_get(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(odict_get(&map, NULL, 0, NULL), 1);
+	EXPECT_EQ(odict_remove(NULL, NULL, 0, NULL), 1);
+	EXPECT_EQ(odict_remove(&map, NULL, 0, NULL), 1);
+
+	EXPECT_EQ(odict_get(&map, "a", 1, &value), 1);
+	EXPECT_EQ(odict_set(&map, "a", 1, &a), 0);
+	EXPECT_EQ(odict_set(&map, "b", 1, &b), 0);
+	EXPECT_EQ(odict_get(&map, "a", 1, &value), 0);
+	EXPECT_PTR(value, &a);
+	EXPECT_EQ(odict_set(&map, "a", 1, &b), 0);
+	EXPECT_EQ(odict_get(&map, "a", 1, &value), 0);
+	EXPECT_PTR(value, &b);
+	EXPECT_EQ(map.cnt, 2);
+	EXPECT_EQ(map.used, 2);
+
+	EXPECT_EQ(odict_remove(&map, "a", 1, &value), 0);
+	EXPECT_PTR(value, &b);
+	EXPECT_EQ(odict_remove(&map, "a", 1, NULL), 1);
+	EXPECT_EQ(odict_get(&map, "a", 1, NULL), 1);
+	EXPECT_EQ(odict_get(&map, "b", 1, NULL), 0);
+	EXPECT_EQ(map.cnt, 1);
+	EXPECT_EQ(map.used, 2);
+
+	odict_reset(&map);
+	odict_reset(NULL);
+	EXPECT_EQ(odict_get(&map, "b", 1, NULL), 1);
+	EXPECT_EQ(map.cnt, 0);
+
+	odict_free(&map);
+
+	END;
+}
+
+static u64 t_odict_hash_cb(const void *key, size_t ksize, const void *priv)
+{
+	(void)priv;
+	u64 hash = 0;
+	for (size_t i = 0; i < ksize; i++) {
+		hash = hash * 31 + (((const char *)key)[i] | 0x20);
+	}
+	return hash * 0x9e3779b97f4a7c15ULL;
+}
+
+static int t_odict_eq_cb(const void *key1, size_t ksize1, const void *key2, size_t ksize2, const void *priv)
+{
+	(void)priv;
+	if (ksize1 != ksize2) {
+		return 0;
+	}
+	for (size_t i = 0; i < ksize1; i++) {
+		if ((((const char *)key1)[i] | 0x20) != (((const char *)key2)[i] | 0x20)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+TEST(odict_set_hash)
+{
+	START;
+
+	odict_t map = {0};
+	odict_init(&map, 0, ALLOC_STD);
+
+	EXPECT_EQ(odict_set_hash(NULL, NULL, NULL, NULL), 1);
+	EXPECT_EQ(odict_set_hash(&map, t_odict_hash_cb, t_odict_eq_cb, NULL), 0);
+
+	int a = 1;
+	EXPECT_EQ(odict_set(&map, "One", 3, &a), 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(odict_set_hash(&map, NULL, NULL, NULL), 1);
+	log_set_quiet(0, 0);
+
+	void *value;
+	EXPECT_EQ(odict_get(&map, "oNE", 3, &value), 0);
+	EXPECT_PTR(value, &a);
+	EXPECT_EQ(odict_remove(&map, "ONE", 3, NULL), 0);
+	EXPECT_EQ(map.cnt, 0);
+
+	odict_free(&map);
+
+	END;
+}
+
+TEST(odict_grow)
+{
+	START;
+
+	odict_t map = {0};
+	odict_init(&map, 0, ALLOC_STD);
+
+	uint keys[1000];
+	for (uint i = 0; i < 1000; i++) {
+		keys[i] = i;
+		EXPECT_EQ(odict_set(&map, &keys[i], sizeof(uint), &keys[i]), 0);
+	}
+
+	EXPECT_EQ(map.cnt, 1000);
+	EXPECT_EQ(map.icap, 2048);
+
+	for (uint i = 0; i < 1000; i += 2) {
+		odict_remove(&map, &keys[i], sizeof(uint), NULL);
+	}
+
+	int fails = 0;
+	for (uint i = 0; i < 1000; i++) {
+		void *value = NULL;
+		fails += odict_get(&map, &keys[i], sizeof(uint), &value) != (i % 2 == 0) || (i % 2 && value != &keys[i]);
+	}
+	EXPECT_EQ(fails, 0);
+
+	odict_free(&map);
+
+	END;
+}
+
+TEST(odict_oom)
+{
+	START;
+
+	odict_t map = {0};
+	odict_init(&map, 6, ALLOC_STD);
+
+	uint keys[9];
+	for (uint i = 0; i < 8; i++) {
+		keys[i] = i;
+		odict_set(&map, &keys[i], sizeof(uint), NULL);
+	}
+
+	keys[8] = 8;
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(odict_set(&map, &keys[8], sizeof(uint), NULL), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(map.cnt, 8);
+
+	odict_remove(&map, &keys[0], sizeof(uint), NULL);
+	odict_remove(&map, &keys[1], sizeof(uint), NULL);
+	mem_oom(1);
+	EXPECT_EQ(odict_set(&map, &keys[8], sizeof(uint), NULL), 0);
+	mem_oom(0);
+	EXPECT_EQ(map.cap, 8);
+	EXPECT_EQ(map.used, 7);
+
+	odict_free(&map);
+
+	END;
+}
+
+TEST(odict_foreach)
+{
+	START;
+
+	odict_t map = {0};
+	odict_init(&map, 0, ALLOC_STD);
+
+	const char *keys[] = {"d", "a", "c", "b", "e"};
+	for (uint i = 0; i < 5; i++) {
+		odict_set(&map, keys[i], 1, NULL);
+	}
+
+	odict_remove(&map, "c", 1, NULL);
+	odict_set(&map, "c", 1, NULL);
+
+	char order[8] = {0};
+	uint cnt      = 0;
+	uint i	      = 0;
+	odict_entry_t *entry;
+	odict_foreach(&map, i, entry)
+	{
+		order[cnt++] = *(const char *)entry->key;
+	}
+	EXPECT_STR(order, "dabec");
+
+	EXPECT_EQ(odict_compact(NULL), 1);
+	EXPECT_EQ(odict_compact(&map), 0);
+	EXPECT_EQ(map.used, 5);
+	EXPECT_EQ(odict_compact(&map), 0);
+
+	cnt = 0;
+	i   = 0;
+	odict_foreach(&map, i, entry)
+	{
+		order[cnt++] = *(const char *)entry->key;
+	}
+	EXPECT_STR(order, "dabec");
+	EXPECT_EQ(odict_get(&map, "c", 1, NULL), 0);
+
+	odict_free(&map);
+
+	END;
+}
+
+TEST(odict_snap)
+{
+	START;
+
+	odict_t map = {0};
+	odict_init(&map, 0, ALLOC_STD);
+
+	odict_set(&map, "a", 1, NULL);
+	odict_set(&map, "b", 1, NULL);
+	odict_set(&map, "c", 1, NULL);
+
+	odict_snap_t snap = odict_snap(&map);
+	EXPECT_EQ(odict_snap_valid(&map, &snap), 1);
+
+	odict_set(&map, "d", 1, NULL);
+	odict_remove(&map, "b", 1, NULL);
+
+	char order[8] = {0};
+	uint cnt      = 0;
+	uint i	      = 0;
+	odict_entry_t *entry;
+	odict_snap_foreach(&map, &snap, i, entry)
+	{
+		order[cnt++] = *(const char *)entry->key;
+	}
+	EXPECT_STR(order, "ac");
+
+	odict_compact(&map);
+	EXPECT_EQ(odict_snap_valid(&map, &snap), 0);
+	i = 0;
+	EXPECT_NULL(odict_snap_next(&map, &snap, &i));
+
+	snap = odict_snap(NULL);
+	EXPECT_EQ(odict_snap_valid(NULL, &snap), 0);
+
+	odict_free(&map);
+
+	END;
+}
+
+STEST(odict)
+{
+	SSTART;
+
+	RUN(odict_init_free);
+	RUN(odict_set_get_remove);
+	RUN(odict_set_hash);
+	RUN(odict_grow);
+	RUN(odict_oom);
+	RUN(odict_foreach);
+	RUN(odict_snap);
+
+	SEND;
+}
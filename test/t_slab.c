@@ -0,0 +1,171 @@
+#include "slab.h"
+
+#include "list.h"
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+TEST(slab_init_free)
+{
+	START;
+
+	slab_t slab = {0};
+
+	EXPECT_NULL(slab_init(NULL, 0, ALLOC_STD));
+	EXPECT_PTR(slab_init(&slab, 256, ALLOC_STD), &slab);
+
+	EXPECT_NULL(slab.pages);
+	EXPECT_EQ(slab.page_size, 256);
+
+	slab_free(&slab);
+	slab_free(NULL);
+
+	EXPECT_NULL(slab.pages);
+
+	END;
+}
+
+TEST(slab_reserve)
+{
+	START;
+
+	slab_t slab = {0};
+	slab_init(&slab, 256, ALLOC_STD);
+
+	alloc_t alloc = ALLOC_SLAB(&slab);
+
+	EXPECT_EQ(slab_reserve(NULL, 0, 0), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(slab_reserve(&slab, 4096, 1), 1);
+	log_set_quiet(0, 0);
+	EXPECT_EQ(slab_reserve(&slab, 24, 0), 0);
+	mem_oom(1);
+	EXPECT_EQ(slab_reserve(&slab, 24, 2), 1);
+	mem_oom(0);
+	EXPECT_EQ(slab_reserve(&slab, 24, 2), 0);
+
+	mem_oom(1);
+	byte *m0 = alloc_alloc(&alloc, 24);
+	byte *m1 = alloc_alloc(&alloc, 32);
+	EXPECT_NULL(alloc_alloc(&alloc, 32));
+	mem_oom(0);
+
+	EXPECT_NOT_NULL(m0);
+	EXPECT_EQ(m1 - m0, 32);
+
+	slab_free(&slab);
+
+	END;
+}
+
+TEST(slab_alloc)
+{
+	START;
+
+	slab_t slab = {0};
+	slab_init(&slab, 0, ALLOC_STD);
+
+	alloc_t alloc = ALLOC_SLAB(&slab);
+	alloc_t null  = ALLOC_SLAB(NULL);
+
+	EXPECT_NULL(alloc_alloc(&null, 1));
+
+	void *m0 = alloc_alloc(&alloc, 1);
+	EXPECT_NOT_NULL(m0);
+	alloc_free(&alloc, m0, 1);
+	EXPECT_PTR(alloc_alloc(&alloc, 16), m0);
+
+	void *m1 = alloc_alloc(&alloc, 4096);
+	EXPECT_NOT_NULL(m1);
+	alloc_free(&alloc, m1, 4096);
+
+	alloc_free(&alloc, NULL, 0);
+	alloc_free(&null, m0, 1);
+
+	slab_free(&slab);
+
+	END;
+}
+
+TEST(slab_realloc)
+{
+	START;
+
+	slab_t slab = {0};
+	slab_init(&slab, 256, ALLOC_STD);
+
+	alloc_t alloc = ALLOC_SLAB(&slab);
+	alloc_t null  = ALLOC_SLAB(NULL);
+
+	size_t size = 8;
+	void *mem   = alloc_alloc(&alloc, size);
+	void *prev  = mem;
+
+	EXPECT_EQ(alloc_realloc(&null, &mem, &size, 16), 1);
+
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 16), 0);
+	EXPECT_PTR(mem, prev);
+	EXPECT_EQ(size, 16);
+
+	*(int *)mem = 1;
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 100), 0);
+	EXPECT_NE(mem, prev);
+	EXPECT_EQ(size, 100);
+	EXPECT_EQ(*(int *)mem, 1);
+
+	mem_oom(1);
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 1024), 1);
+	mem_oom(0);
+	EXPECT_EQ(size, 100);
+
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 4096), 0);
+	EXPECT_EQ(*(int *)mem, 1);
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 8192), 0);
+	EXPECT_EQ(*(int *)mem, 1);
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 8), 0);
+	EXPECT_EQ(*(int *)mem, 1);
+
+	alloc_free(&alloc, mem, size);
+
+	slab_free(&slab);
+
+	END;
+}
+
+TEST(slab_list)
+{
+	START;
+
+	slab_t slab = {0};
+	slab_init(&slab, 1024, ALLOC_STD);
+
+	list_t list = {0};
+	list_init(&list, 1, sizeof(int), ALLOC_SLAB(&slab));
+
+	list_node_t root, node;
+	*(int *)list_node(&list, &root) = 0;
+	for (int i = 1; i < 16; i++) {
+		*(int *)list_node(&list, &node) = i;
+		list_app(&list, root, node);
+	}
+
+	EXPECT_EQ(*(int *)list_get_at(&list, root, 15, NULL), 15);
+
+	list_free(&list);
+	slab_free(&slab);
+
+	END;
+}
+
+STEST(slab)
+{
+	SSTART;
+
+	RUN(slab_init_free);
+	RUN(slab_reserve);
+	RUN(slab_alloc);
+	RUN(slab_realloc);
+	RUN(slab_list);
+
+	SEND;
+}
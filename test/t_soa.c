@@ -0,0 +1,232 @@
+#include "soa.h"
+
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+TEST(soa_init_free)
+{
+	START;
+
+	soa_t soa      = {0};
+	size_t sizes[] = {sizeof(int), sizeof(double)};
+
+	EXPECT_NULL(soa_init(NULL, 0, sizes, 2, ALLOC_STD));
+	EXPECT_NULL(soa_init(&soa, 0, NULL, 2, ALLOC_STD));
+	EXPECT_NULL(soa_init(&soa, 0, sizes, 0, ALLOC_STD));
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_NULL(soa_init(&soa, 1, sizes, 2, ALLOC_STD));
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_PTR(soa_init(&soa, 1, sizes, 2, ALLOC_STD), &soa);
+
+	EXPECT_EQ(soa.ncols, 2);
+	EXPECT_EQ(soa.cap, 1);
+	EXPECT_EQ(soa.cnt, 0);
+	EXPECT_EQ(soa.cols[1].size, sizeof(double));
+
+	soa_free(&soa);
+	soa_free(&soa);
+	soa_free(NULL);
+
+	EXPECT_NULL(soa.cols);
+	EXPECT_EQ(soa.cap, 0);
+
+	END;
+}
+
+TEST(soa_reset)
+{
+	START;
+
+	soa_t soa = {0};
+	soa_init(&soa, 2, (size_t[]){sizeof(int)}, 1, ALLOC_STD);
+
+	soa_add(&soa, NULL);
+	soa_add(&soa, NULL);
+
+	soa_reset(NULL, 0);
+	soa_reset(&soa, 3);
+	EXPECT_EQ(soa.cnt, 2);
+	soa_reset(&soa, 1);
+	EXPECT_EQ(soa.cnt, 1);
+
+	soa_free(&soa);
+
+	END;
+}
+
+TEST(soa_resize)
+{
+	START;
+
+	soa_t soa = {0};
+	soa_init(&soa, 1, (size_t[]){sizeof(int), sizeof(char)}, 2, ALLOC_STD);
+
+	EXPECT_EQ(soa_resize(NULL, 0), 1);
+	EXPECT_EQ(soa_resize(&soa, 1), 0);
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(soa_resize(&soa, 4), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(soa.cap, 1);
+	EXPECT_EQ(soa_resize(&soa, 4), 0);
+	EXPECT_EQ(soa.cap, 4);
+	EXPECT_EQ(soa.cols[0].cap, 4);
+	EXPECT_EQ(soa.cols[1].cap, 4);
+
+	soa_free(&soa);
+
+	END;
+}
+
+TEST(soa_set_grow)
+{
+	START;
+
+	soa_t soa = {0};
+	soa_init(&soa, 10, (size_t[]){sizeof(int), sizeof(char)}, 2, ALLOC_STD);
+
+	soa_set_grow(NULL, (grow_t){0});
+	soa_set_grow(&soa, (grow_t){.pct = 150, .step = 8});
+
+	for (int i = 0; i < 11; i++) {
+		soa_add(&soa, NULL);
+	}
+	EXPECT_EQ(soa.cap, 15);
+	EXPECT_EQ(soa.cols[1].cap, 15);
+
+	for (int i = 0; i < 5; i++) {
+		soa_add(&soa, NULL);
+	}
+	EXPECT_EQ(soa.cap, 22);
+
+	for (int i = 0; i < 7; i++) {
+		soa_add(&soa, NULL);
+	}
+	EXPECT_EQ(soa.cap, 30);
+
+	soa_free(&soa);
+
+	END;
+}
+
+TEST(soa_add)
+{
+	START;
+
+	soa_t soa = {0};
+	soa_init(&soa, 1, (size_t[]){sizeof(int), sizeof(char)}, 2, ALLOC_STD);
+
+	uint id;
+	EXPECT_EQ(soa_add(NULL, NULL), 1);
+	EXPECT_EQ(soa_add(&soa, &id), 0);
+	EXPECT_EQ(id, 0);
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(soa_add(&soa, NULL), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(soa_add(&soa, &id), 0);
+	EXPECT_EQ(id, 1);
+	EXPECT_EQ(soa.cap, 2);
+
+	int i  = 5;
+	char c = 'a';
+	EXPECT_EQ(soa_addv(NULL, NULL, NULL), 1);
+	EXPECT_EQ(soa_addv(&soa, NULL, NULL), 1);
+	EXPECT_EQ(soa_addv(&soa, (const void *[]){&i, &c}, &id), 0);
+	EXPECT_EQ(id, 2);
+	EXPECT_EQ(soa_addv(&soa, (const void *[]){NULL, &c}, NULL), 0);
+
+	EXPECT_EQ(*soa_get_as(&soa, int, 0, 2), 5);
+	EXPECT_EQ(*soa_get_as(&soa, char, 1, 3), 'a');
+
+	soa_free(&soa);
+
+	END;
+}
+
+TEST(soa_get)
+{
+	START;
+
+	soa_t soa = {0};
+	soa_init(&soa, 2, (size_t[]){sizeof(int), sizeof(char)}, 2, ALLOC_STD);
+
+	soa_addv(&soa, (const void *[]){&(int){1}, &(char){'a'}}, NULL);
+	soa_addv(&soa, (const void *[]){&(int){2}, &(char){'b'}}, NULL);
+
+	EXPECT_NULL(soa_col(NULL, 0));
+	EXPECT_NULL(soa_get(NULL, 0, 0));
+	log_set_quiet(0, 1);
+	EXPECT_NULL(soa_col(&soa, 2));
+	EXPECT_NULL(soa_get(&soa, 2, 0));
+	EXPECT_NULL(soa_get(&soa, 0, 2));
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(soa_col_as(&soa, int, 0)[1], 2);
+	EXPECT_EQ(soa_col_as(&soa, char, 1)[0], 'a');
+	EXPECT_EQ(*soa_get_as(&soa, char, 1, 1), 'b');
+
+	void *values[2];
+	EXPECT_EQ(soa_row(NULL, 0, values), 1);
+	EXPECT_EQ(soa_row(&soa, 0, NULL), 1);
+	EXPECT_EQ(soa_row(&soa, 2, values), 1);
+	EXPECT_EQ(soa_row(&soa, 1, values), 0);
+	EXPECT_EQ(*(int *)values[0], 2);
+	EXPECT_EQ(*(char *)values[1], 'b');
+
+	soa_free(&soa);
+
+	END;
+}
+
+TEST(soa_foreach)
+{
+	START;
+
+	soa_t soa = {0};
+	soa_init(&soa, 2, (size_t[]){sizeof(int), sizeof(uint)}, 2, ALLOC_STD);
+
+	soa_addv(&soa, (const void *[]){&(int){0}, &(uint){10}}, NULL);
+	soa_addv(&soa, (const void *[]){&(int){1}, &(uint){11}}, NULL);
+
+	void *values[2];
+	uint i = 0;
+	soa_foreach(&soa, i, values)
+	{
+		EXPECT_EQ(*(int *)values[0], (int)i);
+		EXPECT_EQ(*(uint *)values[1], i + 10);
+	}
+	EXPECT_EQ(i, 2);
+
+	uint *value;
+	i = 0;
+	soa_foreach_col(&soa, 1, i, value)
+	{
+		EXPECT_EQ(*value, i + 10);
+	}
+	EXPECT_EQ(i, 2);
+
+	soa_free(&soa);
+
+	END;
+}
+
+STEST(soa)
+{
+	SSTART;
+
+	RUN(soa_init_free);
+	RUN(soa_reset);
+	RUN(soa_resize);
+	RUN(soa_set_grow);
+	RUN(soa_add);
+	RUN(soa_get);
+	RUN(soa_foreach);
+
+	SEND;
+}
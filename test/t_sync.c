@@ -0,0 +1,142 @@
+#include "sync.h"
+
+#include "test.h"
+
+TEST(lock_acquire_release)
+{
+	START;
+
+	lock_t lock = {0};
+
+	lock_acquire(NULL);
+	lock_acquire(&lock);
+	EXPECT_EQ(lock.locked, 1);
+
+	lock_release(NULL);
+	lock_release(&lock);
+	EXPECT_EQ(lock.locked, 0);
+
+	END;
+}
+
+TEST(atom_add)
+{
+	START;
+
+	volatile size_t val = 1;
+
+	EXPECT_EQ(atom_add(&val, 2), 3);
+	EXPECT_EQ(atom_add(&val, (size_t)-1), 2);
+	EXPECT_EQ(atom_load(&val), 2);
+
+	END;
+}
+
+TEST(atom_xchg)
+{
+	START;
+
+	volatile size_t val = 1;
+
+	EXPECT_EQ(atom_xchg(&val, 2), 1);
+	EXPECT_EQ(atom_load(&val), 2);
+
+	END;
+}
+
+TEST(atom_cas)
+{
+	START;
+
+	volatile size_t val = 1;
+
+	EXPECT_EQ(atom_cas(&val, 2, 3), 0);
+	EXPECT_EQ(atom_load(&val), 1);
+	EXPECT_EQ(atom_cas(&val, 1, 3), 1);
+	EXPECT_EQ(atom_load(&val), 3);
+
+	END;
+}
+
+TEST(atom_cas64)
+{
+	START;
+
+	volatile u64 val = 1;
+
+	EXPECT_EQ(atom_cas64(&val, 2, 0x100000000ULL), 0);
+	EXPECT_EQ(atom_load64(&val), 1);
+	EXPECT_EQ(atom_cas64(&val, 1, 0x100000000ULL), 1);
+	EXPECT_EQ(atom_load64(&val), 0x100000000ULL);
+
+	END;
+}
+
+TEST(atom_cas_ptr)
+{
+	START;
+
+	int a, b;
+	void *volatile ptr = &a;
+
+	EXPECT_EQ(atom_cas_ptr(&ptr, &b, NULL), 0);
+	EXPECT_PTR(ptr, &a);
+	EXPECT_EQ(atom_cas_ptr(&ptr, &a, &b), 1);
+	EXPECT_PTR(ptr, &b);
+
+	END;
+}
+
+static void t_thread_cb(void *priv)
+{
+	atom_add(priv, 1);
+}
+
+TEST(thread_create_join)
+{
+	START;
+
+	volatile size_t cnt = 0;
+	thread_t threads[4];
+
+	EXPECT_EQ(thread_create(NULL, NULL, NULL), 1);
+	EXPECT_EQ(thread_create(&threads[0], NULL, NULL), 1);
+	EXPECT_EQ(thread_join(NULL), 1);
+
+	for (int i = 0; i < 4; i++) {
+		EXPECT_EQ(thread_create(&threads[i], t_thread_cb, (void *)&cnt), 0);
+	}
+
+	for (int i = 0; i < 4; i++) {
+		EXPECT_EQ(thread_join(&threads[i]), 0);
+	}
+
+	EXPECT_EQ(atom_load(&cnt), 4);
+
+	END;
+}
+
+TEST(thread_cpus)
+{
+	START;
+
+	EXPECT_GT(thread_cpus(), 0);
+
+	END;
+}
+
+STEST(sync)
+{
+	SSTART;
+
+	RUN(lock_acquire_release);
+	RUN(atom_add);
+	RUN(atom_xchg);
+	RUN(atom_cas);
+	RUN(atom_cas64);
+	RUN(atom_cas_ptr);
+	RUN(thread_create_join);
+	RUN(thread_cpus);
+
+	SEND;
+}
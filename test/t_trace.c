@@ -0,0 +1,215 @@
+#include "trace.h"
+
+#include "arr.h"
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+TEST(trace_init_free)
+{
+	START;
+
+	trace_t trace = {0};
+
+	EXPECT_NULL(trace_init(NULL, ALLOC_STD, 0));
+	mem_oom(1);
+	EXPECT_NULL(trace_init(&trace, ALLOC_STD, 0));
+	mem_oom(0);
+	EXPECT_PTR(trace_init(&trace, ALLOC_STD, 0), &trace);
+
+	EXPECT_EQ(trace.sites_cnt, 1);
+
+	trace_free(&trace);
+	trace_free(NULL);
+
+	EXPECT_NULL(trace.sites);
+
+	END;
+}
+
+TEST(trace_tag)
+{
+	START;
+
+	trace_t trace = {0};
+	trace_init(&trace, ALLOC_STD, 0);
+
+	EXPECT_NULL(trace_tag(NULL, NULL));
+	EXPECT_NULL(trace_tag(&trace, "a"));
+	EXPECT_STR(trace_tag(&trace, "b"), "a");
+	EXPECT_STR(trace_tag(&trace, "a"), "b");
+	EXPECT_STR(trace_tag(&trace, "c"), "a");
+	EXPECT_STR(trace_tag(&trace, "d"), "c");
+	EXPECT_STR(trace_tag(&trace, NULL), "d");
+	EXPECT_EQ(trace.sites_cnt, 5);
+
+	trace_free(&trace);
+
+	END;
+}
+
+TEST(trace_alloc)
+{
+	START;
+
+	trace_t trace = {0};
+	trace_init(&trace, ALLOC_STD, 1);
+
+	alloc_t alloc = ALLOC_TRACE(&trace);
+	alloc_t null  = ALLOC_TRACE(NULL);
+
+	EXPECT_NULL(alloc_alloc(&null, 1));
+	mem_oom(1);
+	EXPECT_NULL(alloc_alloc(&alloc, 1));
+	mem_oom(0);
+
+	void *ptrs[64];
+	for (int i = 0; i < 64; i++) {
+		ptrs[i] = alloc_alloc(&alloc, i + 1);
+	}
+
+	EXPECT_EQ(trace.cnt, 64);
+	EXPECT_EQ(trace.sites[0].calls, 64);
+	EXPECT_EQ(trace.sites[0].live, 64 * 65 / 2);
+
+	for (int i = 0; i < 64; i += 2) {
+		alloc_free(&alloc, ptrs[i], i + 1);
+	}
+
+	EXPECT_EQ(trace.cnt, 32);
+	EXPECT_EQ(trace.sites[0].cnt, 32);
+	EXPECT_EQ(trace.sites[0].live, 32 * 33);
+
+	for (int i = 1; i < 64; i += 2) {
+		alloc_free(&alloc, ptrs[i], i + 1);
+	}
+
+	EXPECT_EQ(trace.cnt, 0);
+	EXPECT_EQ(trace.sites[0].live, 0);
+	EXPECT_EQ(trace.sites[0].bytes, 64 * 65 / 2);
+
+	alloc_free(&null, ptrs[0], 1);
+	alloc_free(&alloc, NULL, 0);
+
+	trace_free(&trace);
+
+	END;
+}
+
+TEST(trace_realloc)
+{
+	START;
+
+	trace_t trace = {0};
+	trace_init(&trace, ALLOC_STD, 0);
+
+	alloc_t alloc = ALLOC_TRACE(&trace);
+	alloc_t null  = ALLOC_TRACE(NULL);
+
+	trace_tag(&trace, "arr");
+
+	size_t size = 4;
+	void *mem   = alloc_alloc(&alloc, size);
+
+	trace_tag(&trace, NULL);
+
+	EXPECT_EQ(alloc_realloc(&null, &mem, &size, 8), 1);
+	mem_oom(1);
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 8), 1);
+	mem_oom(0);
+	EXPECT_EQ(alloc_realloc(&alloc, &mem, &size, 8), 0);
+	EXPECT_EQ(size, 8);
+
+	EXPECT_EQ(trace.cnt, 1);
+	EXPECT_EQ(trace.sites[1].calls, 2);
+	EXPECT_EQ(trace.sites[1].bytes, 8);
+	EXPECT_EQ(trace.sites[1].live, 8);
+
+	alloc_free(&alloc, mem, size);
+
+	trace_free(&trace);
+
+	END;
+}
+
+TEST(trace_print)
+{
+	START;
+
+	trace_t trace = {0};
+	trace_init(&trace, ALLOC_STD, 0);
+
+	alloc_t alloc = ALLOC_TRACE(&trace);
+
+	arr_t a = {0};
+	arr_t b = {0};
+
+	trace_tag(&trace, "a");
+	arr_init(&a, 1, sizeof(int), alloc);
+	for (int i = 0; i < 4; i++) {
+		arr_add(&a, NULL);
+	}
+
+	trace_tag(&trace, "b");
+	arr_init(&b, 8, sizeof(int), alloc);
+
+	char buf[256] = {0};
+	EXPECT_EQ(trace_print(NULL, TRACE_BY_LIVE, 0, DST_BUF(buf)), 0);
+
+	EXPECT_GT(trace_print(&trace, TRACE_BY_LIVE, 3, DST_BUF(buf)), 0);
+	EXPECT_STR(buf,
+		   "b                live: 32 B (1)  bytes: 32 B  calls: 1\n"
+		   "a                live: 16 B (1)  bytes: 16 B  calls: 3\n");
+
+	EXPECT_GT(trace_print(&trace, TRACE_BY_CALLS, 1, DST_BUF(buf)), 0);
+	EXPECT_STR(buf, "a                live: 16 B (1)  bytes: 16 B  calls: 3\n");
+
+	EXPECT_GT(trace_print(&trace, TRACE_BY_BYTES, 1, DST_BUF(buf)), 0);
+	EXPECT_STR(buf, "b                live: 32 B (1)  bytes: 32 B  calls: 1\n");
+
+	arr_free(&a);
+	arr_free(&b);
+
+	trace_free(&trace);
+
+	END;
+}
+
+TEST(trace_print_live)
+{
+	START;
+
+	trace_t trace = {0};
+	trace_init(&trace, ALLOC_STD, 1);
+
+	alloc_t alloc = ALLOC_TRACE(&trace);
+
+	trace_tag(&trace, "x");
+	void *m0 = alloc_alloc(&alloc, 8);
+	void *m1 = alloc_alloc(&alloc, 16);
+
+	char buf[1024] = {0};
+	EXPECT_EQ(trace_print_live(NULL, 0, DST_BUF(buf)), 0);
+	EXPECT_GT(trace_print_live(&trace, 2, DST_BUF(buf)), 0);
+
+	alloc_free(&alloc, m0, 8);
+	alloc_free(&alloc, m1, 16);
+
+	trace_free(&trace);
+
+	END;
+}
+
+STEST(trace)
+{
+	SSTART;
+
+	RUN(trace_init_free);
+	RUN(trace_tag);
+	RUN(trace_alloc);
+	RUN(trace_realloc);
+	RUN(trace_print);
+	RUN(trace_print_live);
+
+	SEND;
+}
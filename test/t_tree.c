@@ -13,18 +13,18 @@ TEST(tree_init_free)
 	EXPECT_NULL(tree_init(NULL, 0, sizeof(int), ALLOC_STD));
 	EXPECT_PTR(tree_init(&tree, 1, sizeof(int), ALLOC_STD), &tree);
 
-	EXPECT_NOT_NULL(tree.data);
-	EXPECT_EQ(tree.cap, 1);
-	EXPECT_EQ(tree.cnt, 0);
-	EXPECT_NE(tree.size, 0);
+	EXPECT_NOT_NULL(tree.nodes.data);
+	EXPECT_EQ(tree.nodes.cap, 1);
+	EXPECT_EQ(tree.nodes.cnt, 0);
+	EXPECT_NE(tree.nodes.size, 0);
 
 	tree_free(&tree);
 	tree_free(NULL);
 
-	EXPECT_NULL(tree.data);
-	EXPECT_EQ(tree.cap, 0);
-	EXPECT_EQ(tree.cnt, 0);
-	EXPECT_EQ(tree.size, 0);
+	EXPECT_NULL(tree.nodes.data);
+	EXPECT_EQ(tree.nodes.cap, 0);
+	EXPECT_EQ(tree.nodes.cnt, 0);
+	EXPECT_EQ(tree.nodes.size, 0);
 
 	END;
 }
@@ -53,10 +53,10 @@ TEST(tree_reset)
 
 	EXPECT_EQ(*child, -1);
 	EXPECT_EQ(*data, 10);
-	EXPECT_EQ(tree.cnt, 1);
+	EXPECT_EQ(tree.nodes.cnt, 1);
 
 	tree_reset(&tree, 2);
-	EXPECT_EQ(tree.cnt, 1);
+	EXPECT_EQ(tree.nodes.cnt, 1);
 
 	tree_free(&tree);
 
@@ -80,8 +80,8 @@ TEST(tree_node)
 	EXPECT_NOT_NULL(tree_node(&tree, &node));
 	EXPECT_EQ(node, 0);
 
-	EXPECT_EQ(tree.cnt, 1);
-	EXPECT_EQ(tree.cap, 1);
+	EXPECT_EQ(tree.nodes.cnt, 1);
+	EXPECT_EQ(tree.nodes.cap, 1);
 
 	tree_free(&tree);
 
@@ -95,14 +95,14 @@ TEST(tree_add)
 	tree_t tree = {0};
 	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
 
-	EXPECT_EQ(tree_add(NULL, tree.cnt, tree.cnt), 1);
+	EXPECT_EQ(tree_add(NULL, tree.nodes.cnt, tree.nodes.cnt), 1);
 
 	tree_node_t root, n1, n2, n12, got;
 	tree_node(&tree, &root);
 
 	log_set_quiet(0, 1);
-	EXPECT_EQ(tree_add(&tree, tree.cnt, tree.cnt), 1);
-	EXPECT_EQ(tree_add(&tree, root, tree.cnt), 1);
+	EXPECT_EQ(tree_add(&tree, tree.nodes.cnt, tree.nodes.cnt), 1);
+	EXPECT_EQ(tree_add(&tree, root, tree.nodes.cnt), 1);
 	log_set_quiet(0, 0);
 
 	tree_node(&tree, &n1);
@@ -118,6 +118,17 @@ TEST(tree_add)
 	tree_get_next(&tree, n1, &got);
 	EXPECT_EQ(got, n2);
 
+	tree_node_t a, b;
+	tree_node(&tree, &a);
+	tree_node(&tree, &b);
+	EXPECT_EQ(tree_app(&tree, a, b), 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(tree_add(&tree, b, a), 1);
+	log_set_quiet(0, 0);
+	EXPECT_NULL(tree_get_parent(&tree, b, &got));
+	EXPECT_EQ(tree_depth(&tree, b), 0);
+
 	tree_free(&tree);
 
 	END;
@@ -133,16 +144,169 @@ TEST(tree_app)
 	tree_node_t root, node;
 	tree_node(&tree, &root);
 
-	EXPECT_EQ(tree_app(NULL, tree.cnt, tree.cnt), 1);
+	EXPECT_EQ(tree_app(NULL, tree.nodes.cnt, tree.nodes.cnt), 1);
 	log_set_quiet(0, 1);
-	EXPECT_EQ(tree_app(&tree, tree.cnt, tree.cnt), 1);
-	EXPECT_EQ(tree_app(&tree, tree.cnt, root), 1);
+	EXPECT_EQ(tree_app(&tree, tree.nodes.cnt, tree.nodes.cnt), 1);
+	EXPECT_EQ(tree_app(&tree, tree.nodes.cnt, root), 1);
 	log_set_quiet(0, 0);
 	tree_node(&tree, &node);
 	EXPECT_EQ(tree_app(&tree, root, node), 0);
 
-	EXPECT_EQ(tree.cnt, 2);
-	EXPECT_EQ(tree.cap, 2);
+	EXPECT_EQ(tree.nodes.cnt, 2);
+	EXPECT_EQ(tree.nodes.cap, 2);
+
+	tree_node_t parent, child, got;
+	tree_node(&tree, &parent);
+	tree_node(&tree, &child);
+	EXPECT_EQ(tree_add(&tree, parent, child), 0);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(tree_app(&tree, node, child), 1);
+	log_set_quiet(0, 0);
+	EXPECT_NULL(tree_get_next(&tree, node, &got));
+	EXPECT_EQ(tree_remove(&tree, child), 0);
+	EXPECT_NULL(tree_get_child(&tree, parent, &got));
+
+	tree_free(&tree);
+
+	END;
+}
+
+TEST(tree_add_parent)
+{
+	START;
+
+	tree_t tree = {0};
+	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
+
+	tree_node_t root, n1, n2, n12;
+	tree_node(&tree, &root);
+	tree_node(&tree, &n1);
+	tree_node(&tree, &n2);
+	tree_node(&tree, &n12);
+
+	tree_add(&tree, root, n1);
+	tree_add(&tree, n1, n12);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(tree_add(&tree, root, n12), 1);
+	EXPECT_EQ(tree_add(&tree, n12, root), 1);
+	EXPECT_EQ(tree_add(&tree, n2, n2), 1);
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(tree_app(&tree, n1, n2), 0);
+
+	tree_node_t got;
+	tree_get_next(&tree, n1, &got);
+	EXPECT_EQ(got, n2);
+	tree_get_parent(&tree, n2, &got);
+	EXPECT_EQ(got, root);
+
+	tree_free(&tree);
+
+	END;
+}
+
+TEST(tree_move)
+{
+	START;
+
+	tree_t tree = {0};
+	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
+
+	tree_node_t root, n1, n2, n3, n21, got;
+	*(int *)tree_node(&tree, &root) = 0;
+	*(int *)tree_node(&tree, &n1)	= 1;
+	*(int *)tree_node(&tree, &n2)	= 2;
+	*(int *)tree_node(&tree, &n3)	= 3;
+	*(int *)tree_node(&tree, &n21)	= 21;
+	tree_add(&tree, root, n1);
+	tree_add(&tree, root, n2);
+	tree_add(&tree, root, n3);
+	tree_add(&tree, n2, n21);
+
+	EXPECT_EQ(tree_move(NULL, n3, n1), 1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(tree_move(&tree, n3, tree.nodes.cnt), 1);
+	EXPECT_EQ(tree_move(&tree, n2, n21), 1);
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(tree_move(&tree, n3, n1), 0);
+	EXPECT_EQ(tree_move(&tree, n2, n3), 0);
+
+	tree_node_t n4;
+	*(int *)tree_node(&tree, &n4) = 4;
+	EXPECT_EQ(tree_add(&tree, root, n4), 0);
+	tree_get_child(&tree, root, &got);
+	EXPECT_EQ(got, n1);
+	tree_get_next(&tree, n1, &got);
+	EXPECT_EQ(got, n4);
+
+	int sum = 0;
+	tree_node_t node;
+	int depth;
+	tree_foreach(&tree, root, node, depth)
+	{
+		sum += *(int *)tree_get(&tree, node) * depth;
+	}
+	EXPECT_EQ(sum, 1 + 3 * 2 + 2 * 3 + 21 * 4 + 4);
+
+	tree_node_t r1, r2, r3, p;
+	*(int *)tree_node(&tree, &r1) = 1;
+	*(int *)tree_node(&tree, &r2) = 2;
+	*(int *)tree_node(&tree, &r3) = 3;
+	*(int *)tree_node(&tree, &p)  = 4;
+	tree_app(&tree, r1, r2);
+	tree_app(&tree, r1, r3);
+
+	EXPECT_EQ(tree_move(&tree, r2, p), 0);
+	tree_get_next(&tree, r1, &got);
+	EXPECT_EQ(got, r3);
+	tree_get_child(&tree, p, &got);
+	EXPECT_EQ(got, r2);
+	EXPECT_NULL(tree_get_next(&tree, r2, &got));
+	EXPECT_EQ(got, (tree_node_t)-1);
+	EXPECT_NULL(tree_get_parent(&tree, r3, &got));
+
+	tree_free(&tree);
+
+	END;
+}
+
+TEST(tree_get_parent_path)
+{
+	START;
+
+	tree_t tree = {0};
+	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
+
+	tree_node_t root, n1, n12, got;
+	*(int *)tree_node(&tree, &root) = 0;
+	*(int *)tree_node(&tree, &n1)	= 1;
+	*(int *)tree_node(&tree, &n12)	= 12;
+	tree_add(&tree, root, n1);
+	tree_add(&tree, n1, n12);
+
+	EXPECT_NULL(tree_get_parent(NULL, n1, NULL));
+	log_set_quiet(0, 1);
+	EXPECT_NULL(tree_get_parent(&tree, tree.nodes.cnt, NULL));
+	log_set_quiet(0, 0);
+	EXPECT_NULL(tree_get_parent(&tree, root, &got));
+	EXPECT_EQ(got, (tree_node_t)-1);
+	EXPECT_EQ(*(int *)tree_get_parent(&tree, n12, &got), 1);
+	EXPECT_EQ(got, n1);
+
+	EXPECT_EQ(tree_depth(NULL, root), -1);
+	EXPECT_EQ(tree_depth(&tree, root), 0);
+	EXPECT_EQ(tree_depth(&tree, n12), 2);
+
+	tree_node_t path[3];
+	EXPECT_EQ(tree_path(&tree, n12, NULL, 3), 0);
+	EXPECT_EQ(tree_path(&tree, n12, path, 2), 0);
+	EXPECT_EQ(tree_path(&tree, n12, path, 3), 3);
+	EXPECT_EQ(path[0], root);
+	EXPECT_EQ(path[1], n1);
+	EXPECT_EQ(path[2], n12);
 
 	tree_free(&tree);
 
@@ -156,9 +320,9 @@ TEST(tree_remove)
 	tree_t tree = {0};
 	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
 
-	EXPECT_EQ(tree_remove(NULL, tree.cnt), 1);
+	EXPECT_EQ(tree_remove(NULL, tree.nodes.cnt), 1);
 	log_set_quiet(0, 1);
-	EXPECT_EQ(tree_remove(&tree, tree.cnt), 1);
+	EXPECT_EQ(tree_remove(&tree, tree.nodes.cnt), 1);
 	log_set_quiet(0, 0);
 
 	tree_free(&tree);
@@ -218,6 +382,181 @@ TEST(tree_remove_child)
 	END;
 }
 
+TEST(tree_delete)
+{
+	START;
+
+	tree_t tree = {0};
+	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
+
+	tree_node_t root, n1, n2, n3, node;
+	tree_node(&tree, &root);
+	tree_node(&tree, &n1);
+	tree_node(&tree, &n2);
+	tree_node(&tree, &n3);
+	tree_add(&tree, root, n1);
+	tree_add(&tree, root, n2);
+	tree_add(&tree, n1, n3);
+
+	EXPECT_EQ(tree_delete(NULL, n1), 1);
+	EXPECT_EQ(tree_delete(&tree, n1), 0);
+	EXPECT_EQ(tree.freed, 2);
+
+	tree_get_child(&tree, root, &node);
+	EXPECT_EQ(node, n2);
+
+	EXPECT_NOT_NULL(tree_node(&tree, &node));
+	EXPECT_EQ(node, n1);
+	EXPECT_NOT_NULL(tree_node(&tree, &node));
+	EXPECT_EQ(node, n3);
+	EXPECT_EQ(tree.nodes.cnt, 4);
+
+	tree_free(&tree);
+
+	END;
+}
+
+TEST(tree_compact)
+{
+	START;
+
+	tree_t tree = {0};
+	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
+
+	tree_node_t root, n1, n2, n3, n4, node;
+	*(int *)tree_node(&tree, &root) = 0;
+	*(int *)tree_node(&tree, &n1)	= 1;
+	*(int *)tree_node(&tree, &n2)	= 2;
+	*(int *)tree_node(&tree, &n3)	= 3;
+	*(int *)tree_node(&tree, &n4)	= 4;
+	tree_add(&tree, root, n1);
+	tree_add(&tree, root, n2);
+	tree_add(&tree, n2, n3);
+	tree_add(&tree, n3, n4);
+
+	tree_delete(&tree, n1);
+
+	tree_node_t remap[5];
+	EXPECT_EQ(tree_compact(NULL, NULL), 1);
+	EXPECT_EQ(tree_compact(&tree, remap), 0);
+	EXPECT_EQ(tree.nodes.cnt, 4);
+	EXPECT_EQ(remap[n1], (tree_node_t)-1);
+	EXPECT_EQ(remap[n4], 3);
+
+	int sum = 0;
+	int depth;
+	tree_foreach(&tree, remap[root], node, depth)
+	{
+		sum = sum * 10 + *(int *)tree_get(&tree, node);
+	}
+	EXPECT_EQ(sum, 234);
+
+	tree_delete(&tree, remap[n3]);
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(tree_compact(&tree, NULL), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(tree_compact(&tree, NULL), 0);
+	EXPECT_EQ(tree.nodes.cnt, 2);
+	EXPECT_EQ(*(int *)tree_get_child(&tree, 0, NULL), 2);
+
+	tree_reset(&tree, 0);
+	EXPECT_EQ(tree_compact(&tree, NULL), 0);
+
+	tree_free(&tree);
+
+	END;
+}
+
+TEST(tree_freeze)
+{
+	START;
+
+	tree_t tree = {0};
+	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
+
+	tree_node_t root, n1, n2, n11, n21, n22, tmp;
+	*(int *)tree_node(&tree, &root) = 0;
+	*(int *)tree_node(&tree, &n21)	= 21;
+	*(int *)tree_node(&tree, &n1)	= 1;
+	*(int *)tree_node(&tree, &tmp)	= -1;
+	*(int *)tree_node(&tree, &n2)	= 2;
+	*(int *)tree_node(&tree, &n22)	= 22;
+	*(int *)tree_node(&tree, &n11)	= 11;
+	tree_add(&tree, root, n1);
+	tree_add(&tree, root, n2);
+	tree_add(&tree, n1, n11);
+	tree_add(&tree, n2, n21);
+	tree_add(&tree, n2, n22);
+	tree_add(&tree, n11, tmp);
+	tree_delete(&tree, tmp);
+
+	EXPECT_EQ(tree_size(&tree, root), 6);
+	EXPECT_EQ(tree_is_ancestor(&tree, n2, n22), 1);
+
+	tree_node_t remap[7];
+	EXPECT_EQ(tree_freeze(NULL, NULL), 1);
+	EXPECT_EQ(tree_freeze(&tree, remap), 0);
+	EXPECT_EQ(tree.nodes.cnt, 6);
+	EXPECT_EQ(remap[tmp], (tree_node_t)-1);
+
+	int values[6];
+	tree_node_t node = 0;
+	uint cnt	 = 0;
+	tree_foreach_all(&tree, node)
+	{
+		values[cnt++] = *(int *)tree_get(&tree, node);
+	}
+	EXPECT_EQ(cnt, 6);
+	EXPECT_EQ(values[0], 0);
+	EXPECT_EQ(values[1], 1);
+	EXPECT_EQ(values[2], 11);
+	EXPECT_EQ(values[3], 2);
+	EXPECT_EQ(values[4], 21);
+	EXPECT_EQ(values[5], 22);
+
+	n2  = remap[n2];
+	n21 = remap[n21];
+	n11 = remap[n11];
+
+	EXPECT_EQ(tree_size(NULL, n2), 0);
+	EXPECT_EQ(tree_size(&tree, remap[root]), 6);
+	EXPECT_EQ(tree_size(&tree, n2), 3);
+	EXPECT_EQ(tree_is_ancestor(NULL, n2, n21), 0);
+	EXPECT_EQ(tree_is_ancestor(&tree, n2, n21), 1);
+	EXPECT_EQ(tree_is_ancestor(&tree, n2, n2), 1);
+	EXPECT_EQ(tree_is_ancestor(&tree, n2, n11), 0);
+	EXPECT_EQ(tree_is_ancestor(&tree, n21, n2), 0);
+
+	tree_node(&tree, &node);
+	tree_add(&tree, n21, node);
+	EXPECT_EQ(tree_size(&tree, n2), 4);
+	EXPECT_EQ(tree_is_ancestor(&tree, n2, node), 1);
+	EXPECT_EQ(tree_is_ancestor(&tree, n11, node), 0);
+
+	EXPECT_EQ(tree_move(&tree, n21, n11), 0);
+	EXPECT_EQ(tree_is_ancestor(&tree, n2, node), 0);
+	EXPECT_EQ(tree_is_ancestor(&tree, n11, node), 1);
+	EXPECT_EQ(tree_size(&tree, n2), 2);
+
+	mem_oom(1);
+	log_set_quiet(0, 1);
+	EXPECT_EQ(tree_freeze(&tree, NULL), 1);
+	EXPECT_EQ(tree_freeze(&tree, remap), 1);
+	log_set_quiet(0, 0);
+	mem_oom(0);
+	EXPECT_EQ(tree_freeze(&tree, NULL), 0);
+	EXPECT_EQ(tree_size(&tree, 0), 7);
+
+	tree_reset(&tree, 0);
+	EXPECT_EQ(tree_freeze(&tree, NULL), 0);
+
+	tree_free(&tree);
+
+	END;
+}
+
 TEST(tree_get)
 {
 	START;
@@ -225,9 +564,9 @@ TEST(tree_get)
 	tree_t tree = {0};
 	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
 
-	EXPECT_NULL(tree_get(NULL, tree.cnt));
+	EXPECT_NULL(tree_get(NULL, tree.nodes.cnt));
 	log_set_quiet(0, 1);
-	EXPECT_NULL(tree_get(&tree, tree.cnt));
+	EXPECT_NULL(tree_get(&tree, tree.nodes.cnt));
 	log_set_quiet(0, 0);
 
 	tree_node_t root;
@@ -246,9 +585,9 @@ TEST(tree_get_child)
 	tree_t tree = {0};
 	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
 
-	EXPECT_NULL(tree_get_child(NULL, tree.cnt, NULL));
+	EXPECT_NULL(tree_get_child(NULL, tree.nodes.cnt, NULL));
 	log_set_quiet(0, 1);
-	EXPECT_NULL(tree_get_child(&tree, tree.cnt, NULL));
+	EXPECT_NULL(tree_get_child(&tree, tree.nodes.cnt, NULL));
 	log_set_quiet(0, 0);
 
 	tree_node_t root, n1, n2, n3, node;
@@ -345,9 +684,9 @@ TEST(tree_iterate_pre_root)
 
 	int cnt = 0;
 
-	EXPECT_EQ(tree_iterate_pre(NULL, tree.cnt, NULL, 0, &cnt), 0);
+	EXPECT_EQ(tree_iterate_pre(NULL, tree.nodes.cnt, NULL, 0, &cnt), 0);
 	log_set_quiet(0, 1);
-	EXPECT_EQ(tree_iterate_pre(&tree, tree.cnt, NULL, 0, &cnt), 0);
+	EXPECT_EQ(tree_iterate_pre(&tree, tree.nodes.cnt, NULL, 0, &cnt), 0);
 	log_set_quiet(0, 0);
 	EXPECT_EQ(tree_iterate_pre(&tree, root, NULL, 0, &cnt), 0);
 	EXPECT_EQ(tree_iterate_pre(&tree, root, test_iterate_pre_root_cb, 0, &cnt), 0);
@@ -753,8 +1092,8 @@ TEST(tree_it_begin)
 	tree_t tree = {0};
 	tree_init(&tree, 1, sizeof(int), ALLOC_STD);
 
-	tree_it_begin(NULL, tree.cnt);
-	tree_it_begin(&tree, tree.cnt);
+	tree_it_begin(NULL, tree.nodes.cnt);
+	tree_it_begin(&tree, tree.nodes.cnt);
 
 	tree_node_t root;
 	tree_node(&tree, &root);
@@ -796,7 +1135,7 @@ TEST(tree_foreach_root)
 	int depth;
 
 	int i = 0;
-	tree_foreach(&tree, tree.cnt, node, depth)
+	tree_foreach(&tree, tree.nodes.cnt, node, depth)
 	{
 	}
 
@@ -963,7 +1302,7 @@ TEST(tree_foreach_child_child)
 
 	log_set_quiet(0, 1);
 	i = 0;
-	tree_foreach_child(&tree, tree.cnt, node, value)
+	tree_foreach_child(&tree, tree.nodes.cnt, node, value)
 	{
 		i++;
 	}
@@ -1084,8 +1423,8 @@ TEST(tree_print)
 	tree_add(&tree, n11, n111);
 
 	char buf[64] = {0};
-	EXPECT_EQ(tree_print(NULL, tree.cnt, NULL, DST_BUF(buf), NULL), 0);
-	EXPECT_EQ(tree_print(&tree, tree.cnt, NULL, DST_BUF(buf), NULL), 0);
+	EXPECT_EQ(tree_print(NULL, tree.nodes.cnt, NULL, DST_BUF(buf), NULL), 0);
+	EXPECT_EQ(tree_print(&tree, tree.nodes.cnt, NULL, DST_BUF(buf), NULL), 0);
 	EXPECT_EQ(tree_print(&tree, root, NULL, DST_BUF(buf), NULL), 0);
 
 	EXPECT_EQ(tree_print(&tree, root, NULL, DST_BUF(buf), NULL), 0);
@@ -1146,9 +1485,15 @@ STEST(tree)
 	RUN(tree_node);
 	RUN(tree_add);
 	RUN(tree_app);
+	RUN(tree_add_parent);
+	RUN(tree_move);
+	RUN(tree_get_parent_path);
 	RUN(tree_remove);
 	RUN(tree_remove_next);
 	RUN(tree_remove_child);
+	RUN(tree_delete);
+	RUN(tree_compact);
+	RUN(tree_freeze);
 	RUN(tree_get);
 	RUN(tree_get_child);
 	RUN(tree_get_child_data);
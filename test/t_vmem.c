@@ -0,0 +1,182 @@
+#include "vmem.h"
+
+#include "buf.h"
+#include "log.h"
+#include "mem.h"
+#include "test.h"
+
+TEST(vmem_init_free)
+{
+	START;
+
+	vmem_t vmem = {0};
+
+	EXPECT_NULL(vmem_init(NULL, 0, 0));
+	log_set_quiet(0, 1);
+	EXPECT_NULL(vmem_init(&vmem, (size_t)-1 / 2, 0));
+	log_set_quiet(0, 0);
+	EXPECT_PTR(vmem_init(&vmem, 1, 0), &vmem);
+
+	EXPECT_NOT_NULL(vmem.base);
+	EXPECT_EQ(vmem.reserved, vmem.page);
+	EXPECT_EQ(vmem.committed, 0);
+
+	vmem_free(&vmem);
+	vmem_free(&vmem);
+	vmem_free(NULL);
+
+	EXPECT_NULL(vmem.base);
+
+	EXPECT_PTR(vmem_init(&vmem, 1, VMEM_THP), &vmem);
+	EXPECT_EQ(vmem.reserved, 2 * 1024 * 1024);
+	EXPECT_EQ((size_t)vmem.base % (2 * 1024 * 1024), 0);
+	vmem_free(&vmem);
+
+	END;
+}
+
+TEST(vmem_hugetlb)
+{
+	START;
+
+	vmem_t vmem = {0};
+
+	log_set_quiet(0, 1);
+	EXPECT_PTR(vmem_init(&vmem, 4 * 1024 * 1024, VMEM_HUGETLB), &vmem);
+	log_set_quiet(0, 0);
+
+	EXPECT_EQ(vmem.reserved, 4 * 1024 * 1024);
+	EXPECT_EQ((size_t)vmem.base % (2 * 1024 * 1024), 0);
+	EXPECT_EQ(vmem.flags == VMEM_HUGETLB || vmem.flags == VMEM_THP, 1);
+
+	alloc_t alloc = ALLOC_VMEM(&vmem);
+
+	byte *data = alloc_alloc(&alloc, 3 * 1024 * 1024);
+	EXPECT_NOT_NULL(data);
+	mem_set(data, 1, 3 * 1024 * 1024);
+	EXPECT_EQ(data[0] + data[3 * 1024 * 1024 - 1], 2);
+	EXPECT_EQ(vmem.committed, 4 * 1024 * 1024);
+
+	vmem_free(&vmem);
+
+	END;
+}
+
+TEST(vmem_alloc)
+{
+	START;
+
+	vmem_t vmem = {0};
+	vmem_init(&vmem, 1024 * 1024, 0);
+
+	alloc_t alloc = ALLOC_VMEM(&vmem);
+	alloc_t null  = ALLOC_VMEM(NULL);
+
+	EXPECT_NULL(alloc_alloc(&null, 1));
+
+	byte *m0 = alloc_alloc(&alloc, 1);
+	byte *m1 = alloc_alloc(&alloc, 1);
+	EXPECT_NOT_NULL(m0);
+	EXPECT_EQ(m1 - m0, 2 * sizeof(void *));
+	EXPECT_EQ(vmem.committed, vmem.page);
+
+	log_set_quiet(0, 1);
+	EXPECT_NULL(alloc_alloc(&alloc, 2 * 1024 * 1024));
+	log_set_quiet(0, 0);
+
+	alloc_free(&alloc, m1, 1);
+	EXPECT_PTR(alloc_alloc(&alloc, 1), m1);
+	alloc_free(&alloc, NULL, 0);
+	alloc_free(&null, m0, 1);
+
+	vmem_reset(NULL);
+	vmem_reset(&vmem);
+	EXPECT_PTR(alloc_alloc(&alloc, 1), m0);
+
+	vmem_free(&vmem);
+	EXPECT_NULL(alloc_alloc(&alloc, 1));
+
+	END;
+}
+
+TEST(vmem_realloc)
+{
+	START;
+
+	vmem_t vmem = {0};
+	vmem_init(&vmem, 1024 * 1024, 0);
+
+	alloc_t alloc = ALLOC_VMEM(&vmem);
+	alloc_t null  = ALLOC_VMEM(NULL);
+
+	size_t s0 = 8;
+	size_t s1 = 8;
+	void *m0  = alloc_alloc(&alloc, s0);
+	void *m1  = alloc_alloc(&alloc, s1);
+	void *p	  = m1;
+
+	EXPECT_EQ(alloc_realloc(&null, &m1, &s1, 16), 1);
+
+	EXPECT_EQ(alloc_realloc(&alloc, &m1, &s1, 64 * 1024), 0);
+	EXPECT_PTR(m1, p);
+	EXPECT_EQ(s1, 64 * 1024);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(alloc_realloc(&alloc, &m1, &s1, 2 * 1024 * 1024), 1);
+	log_set_quiet(0, 0);
+
+	p = m0;
+	EXPECT_EQ(alloc_realloc(&alloc, &m0, &s0, 4), 0);
+	EXPECT_PTR(m0, p);
+	*(int *)m0 = 1;
+	EXPECT_EQ(alloc_realloc(&alloc, &m0, &s0, 16), 0);
+	EXPECT_NE(m0, p);
+	EXPECT_EQ(*(int *)m0, 1);
+
+	log_set_quiet(0, 1);
+	EXPECT_EQ(alloc_realloc(&alloc, &m0, &s0, 2 * 1024 * 1024), 1);
+	log_set_quiet(0, 0);
+
+	vmem_free(&vmem);
+
+	END;
+}
+
+TEST(vmem_buf)
+{
+	START;
+
+	vmem_t vmem = {0};
+	vmem_init(&vmem, 16 * 1024 * 1024, 0);
+
+	buf_t buf = {0};
+	buf_init(&buf, 16, ALLOC_VMEM(&vmem));
+
+	void *data = buf.data;
+
+	byte chunk[1024] = {0};
+	for (int i = 0; i < 4 * 1024; i++) {
+		buf_add(&buf, sizeof(chunk), chunk, NULL);
+	}
+
+	EXPECT_PTR(buf.data, data);
+	EXPECT_EQ(buf.used, 4 * 1024 * 1024);
+
+	buf_free(&buf);
+	vmem_free(&vmem);
+
+	END;
+}
+
+STEST(vmem)
+{
+	SSTART;
+
+	RUN(vmem_init_free);
+	RUN(vmem_hugetlb);
+	RUN(vmem_alloc);
+	RUN(vmem_realloc);
+	RUN(vmem_buf);
+
+	SEND;
+}